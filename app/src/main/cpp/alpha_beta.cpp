@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "alpha_beta.hpp"
+#include "heuristics.hpp"
+#include "move_generator.hpp"
+#include "symmetry.hpp"
+#include "zobrist.hpp"
+
+// Scores beyond this are wins or losses, whose scores depend on the ply they occur at
+static constexpr double WIN_THRESHOLD = AlphaBeta::WIN_SCORE - 1000.0;
+
+// Win and loss scores are stored relative to the node, not to the root
+static double to_table( double score, int ply )
+{
+	if( score > WIN_THRESHOLD )
+		return score + ply;
+	else
+		if( score < -WIN_THRESHOLD )
+			return score - ply;
+		else
+			return score;
+}
+
+static double from_table( double score, int ply )
+{
+	if( score > WIN_THRESHOLD )
+		return score - ply;
+	else
+		if( score < -WIN_THRESHOLD )
+			return score + ply;
+		else
+			return score;
+}
+
+static Move slot_move( int slot )
+{
+	return Move( slot / 36 + 1, ( slot % 36 ) / 6, slot % 6 );
+}
+
+// heuristic_state for the player who just moved, i.e., the opponent of the player to move
+static double leaf_score( const State &state )
+{
+	jboolean mover_is_blue = !state.blue_turn;
+
+#if POBO_SYMMETRIC_EVALUATION
+	return symmetric_heuristic_state( state.grid, mover_is_blue, state.blue_pool, state.red_pool );
+#else
+	std::uint64_t hash = zobrist_perspective( state.hash, state.blue_turn, mover_is_blue );
+	TranspositionTable &table = evaluation_table();
+	TranspositionEntry entry;
+	if( table.probe( hash, entry ) )
+		return entry.score;
+
+	double score = HeuristicEvaluator( state.grid, mover_is_blue, state.blue_pool, state.red_pool ).score();
+	table.store( hash, score, 0, Bound::EXACT );
+	return score;
+#endif
+}
+
+AlphaBeta::AlphaBeta( int log2_table_buckets )
+	: _table( log2_table_buckets ),
+	  _is_timeout( false ),
+	  _nodes( 0 )
+{ }
+
+double AlphaBeta::negamax( const State &state, int depth, int ply, double alpha, double beta )
+{
+	++_nodes;
+	if( ( _nodes & 63 ) == 0 && std::chrono::steady_clock::now() >= _deadline )
+		_is_timeout = true;
+
+	if( _is_timeout )
+		return 0.0;
+
+	if( depth == 0 )
+		return -leaf_score( state );
+
+	double original_alpha = alpha;
+	int table_slot = -1;
+	TranspositionEntry entry;
+
+	if( _table.probe( state.hash, entry ) )
+	{
+		table_slot = entry.move_slot;
+
+		// the root always searches its moves, to get its best one
+		if( ply > 0 && entry.depth >= depth )
+		{
+			double score = from_table( entry.score, ply );
+			if( entry.bound == Bound::EXACT )
+				return score;
+			else
+				if( entry.bound == Bound::LOWER )
+					alpha = std::max( alpha, score );
+				else
+					beta = std::min( beta, score );
+
+			if( alpha >= beta )
+				return score;
+		}
+	}
+
+	std::vector<Move> moves = legal_moves( state );
+	if( moves.empty() )
+		return -leaf_score( state );
+
+	// Move ordering: the best move of a previous search first, then by greedy score.
+	// Scoring all moves is only worth it when their subtrees are deep enough.
+	if( depth >= 2 )
+	{
+		double scores[ NUMBER_MOVE_SLOTS ];
+		score_moves( state, scores );
+		std::stable_sort( moves.begin(), moves.end(), [&scores]( const Move &a, const Move &b )
+		{
+			return scores[ move_slot( a.piece, a.row, a.col ) ] > scores[ move_slot( b.piece, b.row, b.col ) ];
+		} );
+	}
+
+	if( table_slot >= 0 )
+	{
+		auto table_move = std::find( moves.begin(), moves.end(), slot_move( table_slot ) );
+		if( table_move != moves.end() )
+			std::rotate( moves.begin(), table_move, table_move + 1 );
+	}
+
+	double best_score = -std::numeric_limits<double>::infinity();
+	int best_slot = -1;
+
+	for( auto &move : moves )
+	{
+		State child = state;
+		int winner = play_move( child, move );
+		double score;
+
+		if( winner != 0 )
+		{
+			bool mover_wins = ( winner == -1 ) == static_cast<bool>( state.blue_turn );
+			score = mover_wins ? WIN_SCORE - ( ply + 1 ) : -( WIN_SCORE - ( ply + 1 ) );
+		}
+		else
+			score = -negamax( child, depth - 1, ply + 1, -beta, -alpha );
+
+		if( _is_timeout )
+			return 0.0;
+
+		if( score > best_score )
+		{
+			best_score = score;
+			best_slot = move_slot( move.piece, move.row, move.col );
+		}
+
+		alpha = std::max( alpha, score );
+		if( alpha >= beta )
+			break;
+	}
+
+	Bound bound;
+	if( best_score <= original_alpha )
+		bound = Bound::UPPER;
+	else
+		if( best_score >= beta )
+			bound = Bound::LOWER;
+		else
+			bound = Bound::EXACT;
+
+	_table.store( state.hash, to_table( best_score, ply ), depth, bound, best_slot );
+	return best_score;
+}
+
+std::vector<Move> AlphaBeta::principal_variation( const State &state, int depth ) const
+{
+	std::vector<Move> moves;
+	State current = state;
+	TranspositionEntry entry;
+
+	for( int ply = 0 ; ply < depth ; ++ply )
+	{
+		if( !_table.probe( current.hash, entry ) || entry.move_slot < 0 )
+			break;
+
+		// hash collisions could give a move that is not legal here
+		Move move = slot_move( entry.move_slot );
+		const Pool &pool = current.blue_turn ? current.blue_pool : current.red_pool;
+		if( !pool.has( move.piece ) || current.grid[ move.row * 6 + move.col ] != 0 )
+			break;
+
+		moves.push_back( move );
+		if( play_move( current, move ) != 0 )
+			break;
+	}
+
+	return moves;
+}
+
+SearchResult AlphaBeta::search( const State &state, long timeout_in_ms, int max_depth )
+{
+	_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds( timeout_in_ms );
+	_is_timeout = false;
+	_nodes = 0;
+
+	SearchResult result{ 0.0, 0, 0, {} };
+
+	for( int depth = 1 ; depth <= max_depth ; ++depth )
+	{
+		double score = negamax( state,
+		                        depth,
+		                        0,
+		                        -std::numeric_limits<double>::infinity(),
+		                        std::numeric_limits<double>::infinity() );
+
+		// an interrupted iteration is not reliable
+		if( _is_timeout )
+			break;
+
+		result.score = score;
+		result.depth = depth;
+		result.principal_variation = principal_variation( state, depth );
+
+		// the outcome of the game is known: deeper searches would not change it
+		if( std::abs( score ) > WIN_THRESHOLD )
+			break;
+	}
+
+	result.nodes = _nodes;
+	return result;
+}
@@ -0,0 +1,43 @@
+#ifndef POBO_ALPHA_BETA_HPP
+#define POBO_ALPHA_BETA_HPP
+
+#include <chrono>
+#include <vector>
+
+#include "game.hpp"
+#include "transposition_table.hpp"
+
+struct SearchResult
+{
+	double score; // from the point of view of the player to move
+	int depth; // depth of the last completed iteration, 0 if none completed
+	long nodes;
+	std::vector<Move> principal_variation; // starts with the move to play, empty if there are no legal moves
+};
+
+// Negamax search with alpha-beta cuts, iterative deepening and a transposition table.
+// Leaves are scored by heuristic_state for the player who just moved, like in greedy_move:
+// a 1-ply search scores moves like greedy_move, except that wins and losses are detected.
+// Promotions are chosen by play_move.
+class AlphaBeta
+{
+	TranspositionTable _table;
+	std::chrono::steady_clock::time_point _deadline;
+	bool _is_timeout;
+	long _nodes;
+
+	double negamax( const State &state, int depth, int ply, double alpha, double beta );
+	std::vector<Move> principal_variation( const State &state, int depth ) const;
+
+public:
+	// Scores of wins and losses, beyond any heuristic score. Faster wins score higher.
+	static constexpr double WIN_SCORE = 1000000.0;
+
+	explicit AlphaBeta( int log2_table_buckets = 14 );
+
+	// Deepen the search from state until max_depth is reached or timeout_in_ms runs out,
+	// and return the result of the deepest completed iteration
+	SearchResult search( const State &state, long timeout_in_ms, int max_depth );
+};
+
+#endif //POBO_ALPHA_BETA_HPP
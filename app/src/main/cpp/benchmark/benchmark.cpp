@@ -0,0 +1,143 @@
+// Host benchmark of the engine hot paths: nanoseconds per call of simulate_move, heuristic_state,
+// get_promotions and greedy_move (full move selection) over a fixed corpus of positions,
+// then the number of MCTS nodes created in 1 second with 1 thread up to the number of cores.
+// Usage: pobo_benchmark [number_positions] [repetitions]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "game.hpp"
+#include "helpers.hpp"
+#include "heuristics.hpp"
+#include "mcts.hpp"
+#include "simulator.hpp"
+
+struct Position_sample
+{
+	State state;
+	Move move; // a legal move from state
+};
+
+// Positions reached by random games, always from the same seed
+static std::vector<Position_sample> make_corpus( int number_positions )
+{
+	Random rng( 42u );
+	std::vector<Position_sample> corpus;
+	std::vector<Move> no_moves_to_remove;
+
+	while( static_cast<int>( corpus.size() ) < number_positions )
+	{
+		jbyte grid[36] = { 0 };
+		State state = make_state( grid, Pool{ 8, 0 }, Pool{ 8, 0 }, false, 0 );
+
+		int winner = 0;
+		Move move;
+		while( winner == 0 && static_cast<int>( corpus.size() ) < number_positions
+		       && random_move( state, no_moves_to_remove, rng, move ) )
+		{
+			corpus.push_back( { state, move } );
+			winner = play_move( state, move );
+		}
+	}
+
+	return corpus;
+}
+
+// Best time over the repetitions, in nanoseconds per position
+static double time_per_call( const char *name,
+                             const std::vector<Position_sample> &corpus,
+                             int repetitions,
+                             const std::function<void( const Position_sample & )> &call )
+{
+	double best = 0.0;
+
+	for( int repetition = 0 ; repetition < repetitions ; ++repetition )
+	{
+		auto start = std::chrono::steady_clock::now();
+		for( auto &sample : corpus )
+			call( sample );
+		std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+		double per_call = elapsed.count() / corpus.size();
+		if( repetition == 0 || per_call < best )
+			best = per_call;
+	}
+
+	std::printf( "%-16s %12.1f ns/op\n", name, best );
+	return best;
+}
+
+int main( int argc, char **argv )
+{
+	int number_positions = argc > 1 ? std::atoi( argv[1] ) : 2000;
+	int repetitions = argc > 2 ? std::atoi( argv[2] ) : 5;
+	if( number_positions <= 0 || repetitions <= 0 )
+	{
+		std::fprintf( stderr, "Usage: %s [number_positions] [repetitions]\n", argv[0] );
+		return 1;
+	}
+
+	// same random choices from one run to another, in promotions and single-threaded searches too
+	seed_random( 42 );
+	auto corpus = make_corpus( number_positions );
+	std::printf( "%d positions, best of %d runs\n", number_positions, repetitions );
+
+	// accumulated results, printed so that calls cannot be optimized out
+	double checksum = 0.0;
+
+	time_per_call( "simulate_move", corpus, repetitions, [&]( const Position_sample &sample )
+	{
+		State state = sample.state;
+		simulate_move( sample.move.piece,
+		               sample.move.row,
+		               sample.move.col,
+		               state.grid,
+		               state.blue_turn,
+		               state.blue_pool,
+		               state.red_pool );
+		checksum += state.grid[ sample.move.row * 6 + sample.move.col ];
+	} );
+
+	time_per_call( "heuristic_state", corpus, repetitions, [&]( const Position_sample &sample )
+	{
+		State state = sample.state;
+		checksum += heuristic_state( state.grid, state.blue_turn, state.blue_pool, state.red_pool );
+	} );
+
+	time_per_call( "get_promotions", corpus, repetitions, [&]( const Position_sample &sample )
+	{
+		State state = sample.state;
+		checksum += get_promotions( state.grid,
+		                            state.blue_turn,
+		                            state.blue_pool.size(),
+		                            state.red_pool.size() ).size();
+	} );
+
+	Random rng( 42u );
+	std::vector<Move> no_moves_to_remove;
+	time_per_call( "greedy_move", corpus, repetitions, [&]( const Position_sample &sample )
+	{
+		Move move;
+		if( greedy_move( sample.state, no_moves_to_remove, rng, move ) )
+			checksum += move.piece;
+	} );
+
+	// MCTS_GHOST default parameters, from a mid-game position of the corpus
+	const State &mcts_state = corpus[ corpus.size() / 2 ].state;
+	int max_threads = std::max( 1u, std::thread::hardware_concurrency() );
+	WorkerPool workers;
+	for( int threads = 1 ; threads <= max_threads ; threads *= 2 )
+	{
+		MCTS mcts( workers, 5, true, 21, 21, 6, 0.9, threads );
+		mcts.select_move( mcts_state, mcts_state.blue_turn, 0, 1000 );
+		std::printf( "mcts %2d threads %9d nodes/s\n", threads, mcts.number_nodes() );
+	}
+
+	std::printf( "checksum %g\n", checksum );
+	return 0;
+}
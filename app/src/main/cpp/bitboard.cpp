@@ -0,0 +1,105 @@
+#include "bitboard.hpp"
+
+Alignments get_alignments( const Bitboard &board, Direction direction )
+{
+	Alignments alignments;
+
+	alignments.two_bo = two_in_a_row( board.blue_bo, direction ) | two_in_a_row( board.red_bo, direction );
+	alignments.two_po = two_in_a_row( board.blue_po, direction ) | two_in_a_row( board.red_po, direction );
+	alignments.two_pieces = two_in_a_row( board.blue(), direction ) | two_in_a_row( board.red(), direction );
+
+	// two pairs sharing their middle cell are necessarily of the same colour
+	alignments.three_bo = alignments.two_bo & next_cells( alignments.two_bo, direction );
+	alignments.three_po = alignments.two_po & next_cells( alignments.two_po, direction );
+	alignments.three_pieces = alignments.two_pieces & next_cells( alignments.two_pieces, direction );
+
+	return alignments;
+}
+
+Bitboard to_bitboard( const jbyte * const simulation_grid )
+{
+	Bitboard board{ 0, 0, 0, 0, { 0, 0 }, { 0, 0 } };
+
+	for( int row = 0 ; row < 6 ; ++row )
+		for( int col = 0 ; col < 6 ; ++col )
+			switch( simulation_grid[ row*6 + col ] )
+			{
+				case -2:
+					board.blue_bo |= cell_mask( row, col );
+					break;
+				case -1:
+					board.blue_po |= cell_mask( row, col );
+					break;
+				case 1:
+					board.red_po |= cell_mask( row, col );
+					break;
+				case 2:
+					board.red_bo |= cell_mask( row, col );
+					break;
+				default:
+					break;
+			}
+
+	return board;
+}
+
+Bitboard to_bitboard( const jbyte * const simulation_grid,
+                      const Pool &blue_pool,
+                      const Pool &red_pool )
+{
+	Bitboard board = to_bitboard( simulation_grid );
+	board.blue_pool = blue_pool;
+	board.red_pool = red_pool;
+
+	return board;
+}
+
+void to_grid( const Bitboard &board, jbyte * const simulation_grid )
+{
+	for( int row = 0 ; row < 6 ; ++row )
+		for( int col = 0 ; col < 6 ; ++col )
+		{
+			Bitmask cell = cell_mask( row, col );
+			jbyte piece = 0;
+
+			// masks are disjoint
+			if( board.blue_bo & cell )
+				piece = -2;
+			if( board.blue_po & cell )
+				piece = -1;
+			if( board.red_po & cell )
+				piece = 1;
+			if( board.red_bo & cell )
+				piece = 2;
+
+			simulation_grid[ row*6 + col ] = piece;
+		}
+}
+
+void set_cell( Bitboard &board, int row, int col, jbyte piece )
+{
+	Bitmask cell = cell_mask( row, col );
+
+	board.blue_bo &= ~cell;
+	board.blue_po &= ~cell;
+	board.red_po &= ~cell;
+	board.red_bo &= ~cell;
+
+	switch( piece )
+	{
+		case -2:
+			board.blue_bo |= cell;
+			break;
+		case -1:
+			board.blue_po |= cell;
+			break;
+		case 1:
+			board.red_po |= cell;
+			break;
+		case 2:
+			board.red_bo |= cell;
+			break;
+		default:
+			break;
+	}
+}
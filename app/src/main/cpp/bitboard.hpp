@@ -0,0 +1,123 @@
+#ifndef POBO_BITBOARD_HPP
+#define POBO_BITBOARD_HPP
+
+#include "jni_types.hpp"
+#include <cstdint>
+#include "helpers.hpp"
+#include "pool.hpp"
+
+// Cell (row, col) is bit row*7 + col: the 7th column is always empty,
+// so shifting a mask toward a neighbour never wraps a piece onto another row.
+typedef uint64_t Bitmask;
+
+constexpr int BITBOARD_WIDTH = 7;
+
+constexpr Bitmask ROW_MASK = 0x3fULL;
+constexpr Bitmask BOARD_MASK = ROW_MASK
+                               | ROW_MASK << 7
+                               | ROW_MASK << 14
+                               | ROW_MASK << 21
+                               | ROW_MASK << 28
+                               | ROW_MASK << 35;
+constexpr Bitmask INNER_MASK = 0x1eULL << 7
+                               | 0x1eULL << 14
+                               | 0x1eULL << 21
+                               | 0x1eULL << 28;
+constexpr Bitmask BORDER_MASK = BOARD_MASK & ~INNER_MASK;
+constexpr Bitmask CENTER_MASK = 0x0cULL << 14 | 0x0cULL << 21;
+
+inline int bit_index( int row, int col )
+{
+	return row * BITBOARD_WIDTH + col;
+}
+
+inline Bitmask cell_mask( int row, int col )
+{
+	return 1ULL << bit_index( row, col );
+}
+
+inline int count_cells( Bitmask mask )
+{
+	return __builtin_popcountll( mask );
+}
+
+// Index of the lowest set bit, mask must not be empty
+inline int first_cell( Bitmask mask )
+{
+	return __builtin_ctzll( mask );
+}
+
+// Bit offset from a cell to the next one in the given direction
+constexpr int direction_offset( Direction direction )
+{
+	return direction == TOPRIGHT ? 1 - BITBOARD_WIDTH
+	       : direction == RIGHT ? 1
+	       : direction == BOTTOMRIGHT ? BITBOARD_WIDTH + 1
+	       : BITBOARD_WIDTH; // BOTTOM
+}
+
+// Bit i of the result is bit i + offset of the mask, i.e., the content of the next cell in the given direction
+inline Bitmask next_cells( Bitmask mask, Direction direction )
+{
+	int offset = direction_offset( direction );
+	return offset > 0 ? mask >> offset : mask << -offset;
+}
+
+// Cells of the mask followed by another cell of the mask in the given direction
+inline Bitmask two_in_a_row( Bitmask mask, Direction direction )
+{
+	return mask & next_cells( mask, direction );
+}
+
+// Cells of the mask followed by two other cells of the mask in the given direction
+inline Bitmask three_in_a_row( Bitmask mask, Direction direction )
+{
+	Bitmask two = two_in_a_row( mask, direction );
+	return two & next_cells( two, direction );
+}
+
+struct Bitboard
+{
+	Bitmask blue_po;
+	Bitmask blue_bo;
+	Bitmask red_po;
+	Bitmask red_bo;
+	Pool blue_pool;
+	Pool red_pool;
+
+	Bitmask blue() const { return blue_po | blue_bo; }
+	Bitmask red() const { return red_po | red_bo; }
+	Bitmask occupied() const { return blue() | red(); }
+
+	Bitmask pieces( bool blue_player ) const { return blue_player ? blue() : red(); }
+	Bitmask po( bool blue_player ) const { return blue_player ? blue_po : red_po; }
+	Bitmask bo( bool blue_player ) const { return blue_player ? blue_bo : red_bo; }
+	const Pool &pool( bool blue_player ) const { return blue_player ? blue_pool : red_pool; }
+};
+
+// Starting cells of same-colour alignments in one direction
+struct Alignments
+{
+	Bitmask three_bo;
+	Bitmask three_po;
+	Bitmask three_pieces;
+	Bitmask two_bo;
+	Bitmask two_po;
+	Bitmask two_pieces;
+};
+
+Alignments get_alignments( const Bitboard &board, Direction direction );
+
+// Pieces only, pools are empty
+Bitboard to_bitboard( const jbyte * const simulation_grid );
+
+Bitboard to_bitboard( const jbyte * const simulation_grid,
+                      const Pool &blue_pool,
+                      const Pool &red_pool );
+
+void to_grid( const Bitboard &board, jbyte * const simulation_grid );
+
+// Put the piece (0 for none) at (row, col), whatever was there before
+void set_cell( Bitboard &board, int row, int col, jbyte piece );
+
+#endif //POBO_BITBOARD_HPP
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <limits>
+
+#include "game.hpp"
+#include "helpers.hpp"
+#include "simulator.hpp"
+#include "move_generator.hpp"
+#include "top_k.hpp"
+#include "zobrist.hpp"
+
+State make_state( jbyte * const grid,
+                  const Pool &blue_pool,
+                  const Pool &red_pool,
+                  jboolean blue_turn,
+                  int move_number )
+{
+	State state;
+
+	for( int i = 0 ; i < 36 ; ++i )
+		state.grid[i] = grid[i];
+
+	state.blue_pool = blue_pool;
+	state.red_pool = red_pool;
+	state.blue_turn = blue_turn;
+	state.move_number = move_number;
+	state.hash = zobrist_hash( state.grid, blue_pool, red_pool, blue_turn );
+
+	return state;
+}
+
+int count_empty_positions( const State &state )
+{
+	int count = 0;
+	for( int i = 0 ; i < 36 ; ++i )
+		if( state.grid[i] == 0 )
+			++count;
+
+	return count;
+}
+
+std::vector<Move> legal_moves( const State &state )
+{
+	const Pool &pool = state.blue_turn ? state.blue_pool : state.red_pool;
+
+	std::vector<Move> moves;
+	moves.reserve( 72 );
+	for( int piece = 1 ; piece <= 2 ; ++piece )
+	{
+		if( !pool.has( piece ) )
+			continue;
+
+		for( int index = 0 ; index < 36 ; ++index )
+			if( state.grid[ index ] == 0 )
+				moves.emplace_back( piece, index / 6, index % 6 );
+	}
+
+	return moves;
+}
+
+int play_move( State &state, const Move &move )
+{
+	simulate_push( move.piece,
+	               move.row,
+	               move.col,
+	               state.grid,
+	               state.blue_turn,
+	               state.blue_pool,
+	               state.red_pool,
+	               &state.hash );
+
+	++state.move_number;
+
+	int winner = 0;
+	if( is_victory( state.grid, true, state.blue_pool.size() ) )
+		winner = -1;
+	else
+		if( is_victory( state.grid, false, state.red_pool.size() ) )
+			winner = 1;
+
+	if( winner == 0 )
+		simulate_promotion( state.grid,
+		                    state.blue_turn,
+		                    state.blue_pool,
+		                    state.red_pool,
+		                    &state.hash );
+
+	state.blue_turn = !state.blue_turn;
+	state.hash ^= zobrist_keys.blue_turn;
+	return winner;
+}
+
+bool random_move( const State &state,
+                  const std::vector<Move> &moves_to_remove,
+                  Random &rng,
+                  Move &move )
+{
+	const Pool &pool = state.blue_turn ? state.blue_pool : state.red_pool;
+
+	if( pool.is_empty() )
+		return false;
+
+	// same probabilities as drawing a piece from the pool array, where Bo come first
+	int piece = rng.uniform( 0, pool.size() - 1 ) < pool.bo ? 2 : 1;
+
+	std::vector<int> positions;
+	positions.reserve( 36 );
+	for( int index = 0 ; index < 36 ; ++index )
+	{
+		if( state.grid[ index ] != 0 )
+			continue;
+
+		if( std::find( moves_to_remove.begin(),
+		               moves_to_remove.end(),
+		               Move( piece, index / 6, index % 6 ) ) != moves_to_remove.end() )
+			continue;
+
+		positions.push_back( index );
+	}
+
+	if( positions.empty() )
+		return false;
+
+	int index = rng.pick( positions );
+	move = Move( piece, index / 6, index % 6 );
+	return true;
+}
+
+bool greedy_move( const State &state,
+                  const std::vector<Move> &moves_to_remove,
+                  Random &rng,
+                  Move &move )
+{
+	std::vector<double> costs;
+	std::vector<Move> moves;
+
+	if( !best_moves( state, moves_to_remove, 1, costs, moves ) )
+		return false;
+
+	move = rng.pick( moves );
+	return true;
+}
+
+std::vector<Move> preselected_moves( const State &state,
+                                     int number_preselected_actions,
+                                     Random &rng )
+{
+	TopK<Move> best_moves( number_preselected_actions, rng );
+	visit_moves( state, std::vector<Move>(), [&]( const Move &move, double cost )
+	{
+		best_moves.add( cost, move );
+		return true;
+	} );
+
+	return best_moves.items();
+}
@@ -0,0 +1,81 @@
+#ifndef POBO_GAME_HPP
+#define POBO_GAME_HPP
+
+#include "jni_types.hpp"
+#include <cstdint>
+#include <vector>
+#include "pool.hpp"
+#include "random.hpp"
+
+// A move as returned by the solver: piece type (1 for Po, 2 for Bo), row and column
+struct Move
+{
+	int piece;
+	int row;
+	int col;
+
+	Move()
+	: piece( 0 ),
+	  row( 0 ),
+	  col( 0 )
+	{ }
+
+	Move( int piece, int row, int col )
+	: piece( piece ),
+	  row( row ),
+	  col( col )
+	{ }
+
+	bool operator==( const Move &other ) const
+	{
+		return piece == other.piece && row == other.row && col == other.col;
+	}
+};
+
+// Native counterpart of the Kotlin Game class: a grid, both pools, the player to move and the move number
+struct State
+{
+	jbyte grid[36];
+	Pool blue_pool;
+	Pool red_pool;
+	jboolean blue_turn;
+	int move_number;
+	std::uint64_t hash; // Zobrist hash of the grid, pools and player to move, kept up to date by play_move
+};
+
+State make_state( jbyte * const grid,
+                  const Pool &blue_pool,
+                  const Pool &red_pool,
+                  jboolean blue_turn,
+                  int move_number );
+
+int count_empty_positions( const State &state );
+
+// Same order as MCTS_GHOST.tryEachPossibleMove: Po first, then Bo, positions in row-major order
+std::vector<Move> legal_moves( const State &state );
+
+// Play the move for the current player: push, check victories, promote if nobody won, then change player.
+// Return -1 if Blue wins, 1 if Red wins, 0 otherwise (Blue victory is checked first, like in Game.kt).
+int play_move( State &state, const Move &move );
+
+// Same as randomPlay in RandomPlay.kt: draw a piece from the pool, then an empty position
+// where this piece has not been played in moves_to_remove. Return false if no such move exists.
+bool random_move( const State &state,
+                  const std::vector<Move> &moves_to_remove,
+                  Random &rng,
+                  Move &move );
+
+// Same as ghost_solver_call: the best move according to PoboObjective, not in moves_to_remove,
+// ties being broken randomly. Return false if there are no such moves.
+bool greedy_move( const State &state,
+                  const std::vector<Move> &moves_to_remove,
+                  Random &rng,
+                  Move &move );
+
+// The number_preselected_actions best moves according to PoboObjective, best first, selected in one pass by TopK:
+// moves tied with the last kept one are picked randomly. Return fewer moves if there are not enough legal moves.
+std::vector<Move> preselected_moves( const State &state,
+                                     int number_preselected_actions,
+                                     Random &rng );
+
+#endif //POBO_GAME_HPP
@@ -3,13 +3,8 @@
 //
 
 #include "helpers.hpp"
-
-#include <android/log.h>
-//*
-#define ALOG(...)
-/*/
-#define ALOG( ... ) __android_log_print(ANDROID_LOG_INFO, "pobotag C++", __VA_ARGS__)
-//*/
+#include "bitboard.hpp"
+#include "trace.hpp"
 
 bool check_three_in_a_row( int from_row,
 													 int from_col,
@@ -309,16 +304,16 @@ bool next_to_other_own_pieces( jbyte * const simulation_grid, const Position &po
 				continue;
 			if( is_valid_position( Position( row, col ) ) )
 			{
-				ALOG("Position (%d,%d) is valid\n", row, col);
+				TRACE_HEURISTIC("Position (%d,%d) is valid\n", row, col);
 				if( simulation_grid[ 6 * row + col ] * piece > 0 ) // if we have 2 consecutive pieces of our player
 				{
-					ALOG("Piece at (%d,%d) is next to a friend at (%d,%d)\n", position.row, position.column, row, col);
+					TRACE_HEURISTIC("Piece at (%d,%d) is next to a friend at (%d,%d)\n", position.row, position.column, row, col);
 					return true;
 				}
 			}
 		}
 
-	ALOG("Piece at (%d,%d) is alone in the dark\n", position.row, position.column);
+	TRACE_HEURISTIC("Piece at (%d,%d) is alone in the dark\n", position.row, position.column);
 	return false;
 }
 
@@ -431,53 +426,54 @@ bool is_two_unblocked_bo_and_one_po( int from_row,
 		return false;
 }
 
+bool is_victory( jbyte * const simulation_grid,
+                 jboolean blue,
+                 jint pool_size )
+{
+	Bitmask bo = to_bitboard( simulation_grid ).bo( blue );
+
+	for( int dir = Direction::TOPRIGHT; dir <= Direction::BOTTOM; ++dir )
+		if( three_in_a_row( bo, static_cast<Direction>( dir ) ) )
+			return true;
+
+	return pool_size == 0 && count_cells( bo ) == 8;
+}
+
 std::vector< std::vector<Position> > get_promotions( jbyte * const simulation_grid,
                                                       jboolean blue_turn,
                                                       jint blue_pool_size,
                                                       jint red_pool_size )
 {
+	Bitboard board = to_bitboard( simulation_grid );
+	Bitmask pieces = board.pieces( blue_turn );
+	Bitmask bo = board.bo( blue_turn );
+	bool is_pool_empty = ( blue_turn && blue_pool_size == 0 ) || ( !blue_turn && red_pool_size == 0 );
+
+	// starting cells of groups of 3 aligned pieces, except 3 Bo
+	Bitmask groups[4];
+	for( int dir = Direction::TOPRIGHT; dir <= Direction::BOTTOM; ++dir )
+		groups[ dir ] = three_in_a_row( pieces, static_cast<Direction>( dir ) )
+		                & ~three_in_a_row( bo, static_cast<Direction>( dir ) );
+
 	std::vector< std::vector<Position> > promotions;
-	for( int row = 0 ; row < 6 ; ++row )
-		for( int col = 0 ; col < 6 ; ++col )
-		{
-			int piece = simulation_grid[ 6 * row + col ];
-			if((blue_turn && piece < 0) || (!blue_turn && piece > 0))
+
+	// bits are visited in increasing order, i.e., row by row like the grid
+	for( Bitmask remaining = pieces ; remaining != 0 ; remaining &= remaining - 1 )
+	{
+		int index = first_cell( remaining );
+		Position position( index / BITBOARD_WIDTH, index % BITBOARD_WIDTH );
+
+		if( is_pool_empty )
+			promotions.emplace_back( std::vector<Position>{ position } );
+
+		for( int dir = Direction::TOPRIGHT; dir <= Direction::BOTTOM; ++dir )
+			if( groups[ dir ] & ( 1ULL << index ) )
 			{
-				if((blue_turn && blue_pool_size == 0) || (!blue_turn && red_pool_size == 0))
-				{
-					promotions.emplace_back( std::vector<Position>{Position( row, col )} );
-				}
-				for( int dir = Direction::TOPRIGHT; dir <= Direction::BOTTOM; ++dir )
-				{
-					Position next = get_position_toward( Position( row, col ), dir );
-					Position next_next = get_position_toward( next, dir );
-
-					if( is_valid_position( next )
-					    && !is_empty_position( simulation_grid, next ))
-					{
-						if((blue_turn && is_blue_piece_on( simulation_grid, next ))
-						   || (!blue_turn && !is_blue_piece_on( simulation_grid, next )))
-						{
-							if( is_valid_position( next_next )
-							    && !is_empty_position( simulation_grid, next_next ))
-							{
-								if(((blue_turn && is_blue_piece_on( simulation_grid, next_next ))
-								   || (!blue_turn && !is_blue_piece_on( simulation_grid, next_next )))
-									 && !( std::abs( simulation_grid[ 6 * row + col ] ) == 2
-									       && std::abs( simulation_grid[ 6 * next.row + next.column ] ) == 2
-								         && std::abs( simulation_grid[ 6 * next_next.row + next_next.column ] ) == 2 ))
-								{
-									promotions.emplace_back(
-													std::vector<Position>{Position( row, col ), next, next_next} );
-								}
-							}
-						}
-					}
-				}
+				Position next = get_position_toward( position, dir );
+				Position next_next = get_position_toward( next, dir );
+				promotions.emplace_back( std::vector<Position>{ position, next, next_next } );
 			}
-		}
+	}
 
 	return promotions;
 }
-
-
@@ -5,7 +5,7 @@
 #ifndef HELPERS_HPP
 #define HELPERS_HPP
 
-#include <jni.h>
+#include "jni_types.hpp"
 #include <vector>
 #include "lib/include/ghost/variable.hpp"
 
@@ -82,6 +82,11 @@ bool is_two_unblocked_bo_and_one_po( int from_row,
                                      Direction direction,
                                      jbyte * const simulation_grid );
 
+// True if the given player has 3 Bo aligned, or 8 Bo on the board
+bool is_victory( jbyte * const simulation_grid,
+                 jboolean blue,
+                 jint pool_size );
+
 std::vector< std::vector<Position> > get_promotions( jbyte * const simulation_grid,
 																											jboolean blue_turn,
 																											jint blue_pool_size,
@@ -4,70 +4,44 @@
 
 #include <algorithm>
 #include "heuristics.hpp"
-
-#include <android/log.h>
-//*
-#define ALOG(...)
-/*/
-#define ALOG( ... ) __android_log_print(ANDROID_LOG_INFO, "pobotag C++", __VA_ARGS__)
-//*/
+#include "symmetry.hpp"
+#include "trace.hpp"
 
 double compute_partial_score( int from_row,
                               int from_col,
                               Direction direction,
                               int& jump_forward,
                               jbyte * const simulation_grid,
+                              const Alignments &alignments,
                               jboolean blue_turn,
-                              jbyte * const blue_pool,
-                              jint& blue_pool_size,
-                              jbyte * const red_pool,
-                              jint& red_pool_size )
+                              bool do_current_player_has_bo_in_pool,
+                              bool do_opponent_has_bo_in_pool )
 {
 	double score = 0.;
 	bool is_player_piece = ( ( simulation_grid[ from_row*6 + from_col ] < 0 && blue_turn ) ||
 	                         ( simulation_grid[ from_row*6 + from_col ] > 0 && !blue_turn ) );
+	Bitmask from = cell_mask( from_row, from_col );
 
-	bool do_current_player_has_bo_in_pool = false;
-	bool do_opponent_has_bo_in_pool = false;
-
-	for( int i = 0 ; i < blue_pool_size ; ++i )
-		if( blue_pool[i] == 2 )
-		{
-			if( blue_turn )
-				do_current_player_has_bo_in_pool = true;
-			else
-				do_opponent_has_bo_in_pool = true;
-		}
-
-	for( int i = 0 ; i < red_pool_size ; ++i )
-		if( red_pool[i] == 2 )
-		{
-			if( blue_turn )
-				do_opponent_has_bo_in_pool = true;
-			else
-				do_current_player_has_bo_in_pool = true;
-		}
-
-	if( check_three_in_a_row( from_row, from_col, direction, BO, simulation_grid ))
+	if( alignments.three_bo & from )
 	{
 		score += is_player_piece ? 800 : -800; // 250/-250
-		ALOG( "compute_partial_score 3 Bo aligned from (%d,%d), score=%.2f", from_row, from_col,
+		TRACE_HEURISTIC( "compute_partial_score 3 Bo aligned from (%d,%d), score=%.2f", from_row, from_col,
 		      score );
 		jump_forward = 2;
 	}
 	else
 	{
-		if( check_three_in_a_row( from_row, from_col, direction, PO, simulation_grid ))
+		if( alignments.three_po & from )
 		{
 			score += is_player_piece ? 40 : -44;
 //			score += is_player_piece ? 3 : -3;
-			ALOG( "compute_partial_score 3 Po aligned from (%d,%d), score=%.2f", from_row, from_col,
+			TRACE_HEURISTIC( "compute_partial_score 3 Po aligned from (%d,%d), score=%.2f", from_row, from_col,
 			      score );
 			jump_forward = 2;
 		}
 		else
 		{
-			if( check_three_in_a_row( from_row, from_col, direction, WHATEVER, simulation_grid ))
+			if( alignments.three_pieces & from )
 			{
 				if( is_two_unblocked_bo_and_one_po(from_row, from_col, direction, simulation_grid) )
 				{
@@ -95,7 +69,7 @@ double compute_partial_score( int from_row,
 					score += count_Po_in_a_row( from_row, from_col, direction, simulation_grid ) *
 					         (is_player_piece ? 7 : -11); // 10/-11
 //				score += count_Po_in_a_row( from_row, from_col, direction, simulation_grid );
-					ALOG( "compute_partial_score 3 pieces aligned from (%d,%d), score=%.2f", from_row,
+					TRACE_HEURISTIC( "compute_partial_score 3 pieces aligned from (%d,%d), score=%.2f", from_row,
 					      from_col,
 					      score );
 				}
@@ -103,13 +77,13 @@ double compute_partial_score( int from_row,
 			}
 			else
 			{
-				if( check_two_in_a_row( from_row, from_col, direction, BO, simulation_grid ))
+				if( alignments.two_bo & from )
 				{
 					if( is_two_in_a_row_in_corner( from_row, from_col, direction ))
 					{
 						score += is_player_piece ? -5 : 10;
 //						score += is_player_piece ? 0 : 10;
-						ALOG( "compute_partial_score 2 Bo in the corner from (%d,%d), score=%.2f", from_row,
+						TRACE_HEURISTIC( "compute_partial_score 2 Bo in the corner from (%d,%d), score=%.2f", from_row,
 						      from_col, score );
 					}
 					else
@@ -117,7 +91,7 @@ double compute_partial_score( int from_row,
 						if( is_two_in_a_row_blocked( from_row, from_col, direction, simulation_grid ))
 						{
 							score += is_player_piece ? -5 : 0; // -5/10
-							ALOG( "compute_partial_score 2 Bo aligned from (%d,%d) but blocked, score=%.2f",
+							TRACE_HEURISTIC( "compute_partial_score 2 Bo aligned from (%d,%d) but blocked, score=%.2f",
 							      from_row, from_col, score );
 						}
 						else // 2 Bo aligned, unblocked and not in the corner
@@ -139,7 +113,7 @@ double compute_partial_score( int from_row,
 								else
 									score += -40;
 							}
-							ALOG( "compute_partial_score 2 Bo aligned from (%d,%d), score=%.2f", from_row,
+							TRACE_HEURISTIC( "compute_partial_score 2 Bo aligned from (%d,%d), score=%.2f", from_row,
 							      from_col, score );
 						}
 						jump_forward = 1;
@@ -147,12 +121,12 @@ double compute_partial_score( int from_row,
 				}
 				else // not 2 Bo aligned
 				{
-					if( check_two_in_a_row( from_row, from_col, direction, PO, simulation_grid ))
+					if( alignments.two_po & from )
 					{
 						if( is_two_in_a_row_in_corner( from_row, from_col, direction ))
 						{
 							score += is_player_piece ? -1 : 5;
-							ALOG( "compute_partial_score 2 Po in the corner from (%d,%d) but blocked, score=%.2f",
+							TRACE_HEURISTIC( "compute_partial_score 2 Po in the corner from (%d,%d) but blocked, score=%.2f",
 							      from_row, from_col, score );
 						}
 						else
@@ -160,7 +134,7 @@ double compute_partial_score( int from_row,
 							if( is_two_in_a_row_blocked( from_row, from_col, direction, simulation_grid ))
 							{
 								score += is_player_piece ? -1 : 0;
-								ALOG( "compute_partial_score 2 Po aligned from (%d,%d) but blocked, score=%.2f",
+								TRACE_HEURISTIC( "compute_partial_score 2 Po aligned from (%d,%d) but blocked, score=%.2f",
 								      from_row, from_col, score );
 							}
 							else // 2 Po aligned, unblocked and not in the corner
@@ -174,19 +148,19 @@ double compute_partial_score( int from_row,
 								}
 								else
 									score += -22;
-								ALOG( "compute_partial_score 2 Po aligned from (%d,%d), score=%.2f", from_row,
+								TRACE_HEURISTIC( "compute_partial_score 2 Po aligned from (%d,%d), score=%.2f", from_row,
 								      from_col, score );
 							}
 							jump_forward = 1;
 						}
 					}
 					else
-						if( check_two_in_a_row( from_row, from_col, direction, WHATEVER, simulation_grid ) )
+						if( alignments.two_pieces & from )
 						{
 							if( is_two_in_a_row_in_corner( from_row, from_col, direction ))
 							{
 								score += is_player_piece ? -1 : 5;
-								ALOG( "compute_partial_score 2 pieces in the corner from (%d,%d) but blocked, score=%.2f",
+								TRACE_HEURISTIC( "compute_partial_score 2 pieces in the corner from (%d,%d) but blocked, score=%.2f",
 								      from_row, from_col, score );
 							}
 							else
@@ -194,7 +168,7 @@ double compute_partial_score( int from_row,
 								if( is_two_in_a_row_blocked( from_row, from_col, direction, simulation_grid ))
 								{
 									score += is_player_piece ? -1 : 0;
-									ALOG( "compute_partial_score 2 pieces aligned from (%d,%d) but blocked, score=%.2f",
+									TRACE_HEURISTIC( "compute_partial_score 2 pieces aligned from (%d,%d) but blocked, score=%.2f",
 									      from_row, from_col, score );
 								}
 								else // 2 pieces aligned, unblocked and not in the corner
@@ -208,7 +182,7 @@ double compute_partial_score( int from_row,
 									}
 									else
 										score += -11;
-									ALOG( "compute_partial_score 2 pieces aligned from (%d,%d), score=%.2f", from_row,
+									TRACE_HEURISTIC( "compute_partial_score 2 pieces aligned from (%d,%d), score=%.2f", from_row,
 									      from_col, score );
 								}
 								jump_forward = 1;
@@ -224,209 +198,231 @@ double compute_partial_score( int from_row,
 
 double heuristic_state( jbyte *const simulation_grid,
                         jboolean blue_turn,
-                        jbyte *const blue_pool,
-                        jint blue_pool_size,
-                        jbyte *const red_pool,
-                        jint red_pool_size )
+                        const Pool &blue_pool,
+                        const Pool &red_pool )
 {
-	std::string ss = "";
-	for( int i = 0 ; i < 36 ; ++i )
-	{
-		int p = simulation_grid[i];
-		if( p < 0 )
-			p += 10;
+	TRACE_HEURISTIC_GRID( "heuristic_state", simulation_grid, blue_pool, red_pool );
+
+#if POBO_SYMMETRIC_EVALUATION
+	return symmetric_heuristic_state( simulation_grid, blue_turn, blue_pool, red_pool );
+#else
+	HeuristicEvaluator evaluator( simulation_grid, blue_turn, blue_pool, red_pool );
+	return evaluator.score();
+#endif
+}
 
-		ss += std::to_string(p) + " ";
+// For each scanned line: its direction, its start cells (cells from which an alignment toward the direction
+// can begin, in scan order) and whether its scan goes on from the previous line.
+// Lines are the 6 rows, the 6 columns, then ascendant and descendant diagonals from the bottom left corner.
+// Also, for each cell, the lines going through it (or -1).
+struct LineTable
+{
+	Direction direction[ NUMBER_LINES ];
+	bool continues_previous[ NUMBER_LINES ];
+	int number_start_cells[ NUMBER_LINES ];
+	int start_row[ NUMBER_LINES ][5];
+	int start_col[ NUMBER_LINES ][5];
+	int cell_lines[36][4];
+};
+
+static constexpr LineTable make_line_table()
+{
+	LineTable table{};
+	int line = 0;
 
-		if( (i+1) % 6 == 0 )
+	for( int row = 0 ; row < 6 ; ++row, ++line )
+	{
+		table.direction[ line ] = RIGHT;
+		for( int col = 0 ; col < 5 ; ++col )
 		{
-			ss += "\n";
+			table.start_row[ line ][ col ] = row;
+			table.start_col[ line ][ col ] = col;
 		}
+		table.number_start_cells[ line ] = 5;
 	}
-	ALOG("%s", ss.c_str());
-	ss = "";
-	for( int i = 0 ; i < blue_pool_size ; ++i )
-		ss += std::to_string(blue_pool[i] ) + " ";
-	ALOG("Blue pool: %s", ss.c_str());
-	ss = "";
-	for( int i = 0 ; i < red_pool_size ; ++i )
-		ss += std::to_string(red_pool[i] ) + " ";
-	ALOG("Red pool: %s", ss.c_str());
-	ALOG("\n");
-
-	double score = 0.0;
-
-	int count_blue_po = 0;
-	int count_blue_bo = 0;
-	int count_red_po = 0;
-	int count_red_bo = 0;
-
-	int count_blue_central_po = 0;
-	int count_blue_central_bo = 0;
-	int count_red_central_po = 0;
-	int count_red_central_bo = 0;
-
-	int count_blue_border_po = 0;
-	int count_blue_border_bo = 0;
-	int count_red_border_po = 0;
-	int count_red_border_bo = 0;
 
-	for( int row = 0 ; row < 6 ; ++row )
-		for( int col = 0 ; col < 6 ; ++col )
+	for( int col = 0 ; col < 6 ; ++col, ++line )
+	{
+		table.direction[ line ] = BOTTOM;
+		for( int row = 0 ; row < 5 ; ++row )
 		{
-			int index = row*6 + col;
-
-			if( simulation_grid[ index ] == -1 )
-				++count_blue_po;
-			if( simulation_grid[ index ] == -2 )
-				++count_blue_bo;
-			if( simulation_grid[ index ] == 1 )
-				++count_red_po;
-			if( simulation_grid[ index ] == 2 )
-				++count_red_bo;
-
-			if( row == 0 || row == 5 )
-			{
-				if( simulation_grid[ index ] == -1 )
-					++count_blue_border_po;
-				if( simulation_grid[ index ] == -2 )
-					++count_blue_border_bo;
-				if( simulation_grid[ index ] == 1 )
-					++count_red_border_po;
-				if( simulation_grid[ index ] == 2 )
-					++count_red_border_bo;
-			}
-			else {
-				if( col == 0 || col == 5 ) {
-					if( simulation_grid[ index ] == -1 )
-						++count_blue_border_po;
-					if( simulation_grid[ index ] == -2 )
-						++count_blue_border_bo;
-					if( simulation_grid[ index ] == 1 )
-						++count_red_border_po;
-					if( simulation_grid[ index ] == 2 )
-						++count_red_border_bo;
-				}
-				else {
-					if( index == 14 || index == 15 || index == 20 || index == 21 ) {
-						if( simulation_grid[ index ] == -1 )
-							++count_blue_central_po;
-						if( simulation_grid[ index ] == -2 )
-							++count_blue_central_bo;
-						if( simulation_grid[ index ] == 1 )
-							++count_red_central_po;
-						if( simulation_grid[ index ] == 2 )
-							++count_red_central_bo;
-					}
-				}
-			}
+			table.start_row[ line ][ row ] = row;
+			table.start_col[ line ][ row ] = col;
 		}
+		table.number_start_cells[ line ] = 5;
+	}
 
-	int jump_forward;
-	// horizontal scans
-	for( int row = 0; row < 6; ++row )
+	// cells of an ascendant diagonal share the same row + col, from 1 to 9
+	for( int sum = 1 ; sum <= 9 ; ++sum, ++line )
 	{
-		for( int col = 0; col < 5; col = col + 1 + jump_forward )
-		{
-			jump_forward = 0;
-			if( simulation_grid[row * 6 + col] != 0 )
+		table.direction[ line ] = TOPRIGHT;
+		table.continues_previous[ line ] = sum > 1;
+		int count = 0;
+		for( int row = 5 ; row >= 1 ; --row )
+			if( sum - row >= 0 && sum - row <= 4 )
 			{
-				auto partial_score = compute_partial_score( row,
-				                                            col,
-				                                            RIGHT,
-				                                            jump_forward,
-				                                            simulation_grid,
-				                                            blue_turn,
-				                                            blue_pool,
-				                                            blue_pool_size,
-				                                            red_pool,
-				                                            red_pool_size );
-				score += partial_score;
+				table.start_row[ line ][ count ] = row;
+				table.start_col[ line ][ count ] = sum - row;
+				++count;
 			}
-		}
+		table.number_start_cells[ line ] = count;
 	}
 
-	// vertical scans
-	for( int col = 0; col < 6; ++col )
+	// cells of a descendant diagonal share the same col - row, from -4 to 4
+	for( int difference = -4 ; difference <= 4 ; ++difference, ++line )
 	{
-		for( int row = 0; row < 5; row = row + 1 + jump_forward )
-		{
-			jump_forward = 0;
-			if( simulation_grid[ row * 6 + col ] != 0 )
+		table.direction[ line ] = BOTTOMRIGHT;
+		table.continues_previous[ line ] = difference > -4;
+		int count = 0;
+		for( int row = 0 ; row <= 4 ; ++row )
+			if( row + difference >= 0 && row + difference <= 4 )
 			{
-				auto partial_score = compute_partial_score( row,
-				                                            col,
-				                                            BOTTOM,
-				                                            jump_forward,
-				                                            simulation_grid,
-				                                            blue_turn,
-				                                            blue_pool,
-				                                            blue_pool_size,
-				                                            red_pool,
-				                                            red_pool_size );
-				score += partial_score;
+				table.start_row[ line ][ count ] = row;
+				table.start_col[ line ][ count ] = row + difference;
+				++count;
 			}
+		table.number_start_cells[ line ] = count;
+	}
+
+	for( int row = 0 ; row < 6 ; ++row )
+		for( int col = 0 ; col < 6 ; ++col )
+		{
+			int *lines = table.cell_lines[ row * 6 + col ];
+			lines[0] = row;
+			lines[1] = 6 + col;
+			lines[2] = row + col >= 1 && row + col <= 9 ? 12 + row + col - 1 : -1;
+			lines[3] = col - row >= -4 && col - row <= 4 ? 21 + col - row + 4 : -1;
 		}
+
+	return table;
+}
+
+static constexpr LineTable line_table = make_line_table();
+
+HeuristicEvaluator::HeuristicEvaluator( const jbyte * const simulation_grid,
+                                        jboolean blue_turn,
+                                        const Pool &blue_pool,
+                                        const Pool &red_pool )
+{
+	std::copy( simulation_grid, simulation_grid + 36, _grid );
+	_board = to_bitboard( simulation_grid, blue_pool, red_pool );
+	_blue_turn = blue_turn;
+	_do_current_player_has_bo_in_pool = _board.pool( blue_turn ).has( 2 );
+	_do_opponent_has_bo_in_pool = _board.pool( !blue_turn ).has( 2 );
+
+	bool lines_to_score[ NUMBER_LINES ] = {};
+	score_lines( true, lines_to_score );
+}
+
+void HeuristicEvaluator::update( const jbyte * const simulation_grid,
+                                 const Pool &blue_pool,
+                                 const Pool &red_pool )
+{
+	bool lines_to_score[ NUMBER_LINES ] = {};
+	bool is_modified = false;
+
+	for( int index = 0 ; index < 36 ; ++index )
+	{
+		if( _grid[ index ] == simulation_grid[ index ] )
+			continue;
+
+		is_modified = true;
+		_grid[ index ] = simulation_grid[ index ];
+		set_cell( _board, index / 6, index % 6, simulation_grid[ index ] );
+
+		for( int line : line_table.cell_lines[ index ] )
+			if( line != -1 )
+				lines_to_score[ line ] = true;
 	}
 
-	// ascendant diagonal scans
-	std::vector<int> ascendant{ 6,
-	                            12, 7,
-	                            18, 13, 8,
-	                            24, 19, 14, 9,
-	                            30, 25, 20, 15, 10,
-	                            31, 26, 21, 16,
-	                            32, 27, 22,
-	                            33, 28,
-	                            34 };
-	for( int index = 0 ; index < ascendant.size() ; index = index + 1 + jump_forward )
+	_board.blue_pool = blue_pool;
+	_board.red_pool = red_pool;
+
+	// Bo in pools change the score of every 2-Bo alignment
+	bool do_current_player_has_bo_in_pool = _board.pool( _blue_turn ).has( 2 );
+	bool do_opponent_has_bo_in_pool = _board.pool( !_blue_turn ).has( 2 );
+	bool is_pool_modified = do_current_player_has_bo_in_pool != _do_current_player_has_bo_in_pool
+	                        || do_opponent_has_bo_in_pool != _do_opponent_has_bo_in_pool;
+
+	_do_current_player_has_bo_in_pool = do_current_player_has_bo_in_pool;
+	_do_opponent_has_bo_in_pool = do_opponent_has_bo_in_pool;
+
+	if( is_modified || is_pool_modified )
+		score_lines( is_pool_modified, lines_to_score );
+}
+
+double HeuristicEvaluator::score_line( int line, int skip, int &carry )
+{
+	const Direction direction = line_table.direction[ line ];
+	const int number_start_cells = line_table.number_start_cells[ line ];
+	const int *start_rows = line_table.start_row[ line ];
+	const int *start_cols = line_table.start_col[ line ];
+
+	double score = 0.0;
+	int jump_forward;
+	int index;
+
+	for( index = skip ; index < number_start_cells ; index = index + 1 + jump_forward )
 	{
 		jump_forward = 0;
-		if( simulation_grid[ ascendant[ index ] ] != 0 )
+		if( _grid[ start_rows[ index ] * 6 + start_cols[ index ] ] != 0 )
 		{
-			auto partial_score = compute_partial_score( ascendant[ index ] / 6,
-			                                            ascendant[ index ] % 6,
-			                                            TOPRIGHT,
+			auto partial_score = compute_partial_score( start_rows[ index ],
+			                                            start_cols[ index ],
+			                                            direction,
 			                                            jump_forward,
-			                                            simulation_grid,
-			                                            blue_turn,
-			                                            blue_pool,
-			                                            blue_pool_size,
-			                                            red_pool,
-			                                            red_pool_size );
+			                                            _grid,
+			                                            _alignments[ direction ],
+			                                            _blue_turn,
+			                                            _do_current_player_has_bo_in_pool,
+			                                            _do_opponent_has_bo_in_pool );
 			score += partial_score;
 		}
 	}
 
-	// descendant diagonal scans
-	std::vector<int> descendant{ 24,
-	                             18, 25,
-	                             12, 19, 26,
-	                             6, 13, 20, 27,
-	                             0, 7, 14, 21, 28,
-	                             1, 8, 15, 22,
-	                             2, 9, 16,
-	                             3, 10,
-	                             4 };
-
-	for( int index = 0 ; index < descendant.size() ; index = index + 1 + jump_forward )
+	carry = index - number_start_cells;
+	return score;
+}
+
+void HeuristicEvaluator::score_lines( bool all_lines, const bool ( &lines_to_score )[ NUMBER_LINES ] )
+{
+	for( int dir = Direction::TOPRIGHT; dir <= Direction::BOTTOM; ++dir )
+		_alignments[ dir ] = get_alignments( _board, static_cast<Direction>( dir ) );
+
+	_lines_score = 0.0;
+	for( int line = 0 ; line < NUMBER_LINES ; ++line )
 	{
-		jump_forward = 0;
-		if( simulation_grid[ descendant[ index ] ] != 0 )
+		int skip = line_table.continues_previous[ line ] ? _carries[ line - 1 ] : 0;
+
+		// a diagonal must also be rescanned if the previous one leaves a different number of cells to skip
+		if( all_lines || lines_to_score[ line ] || skip != _skips[ line ] )
 		{
-			auto partial_score = compute_partial_score( descendant[ index ] / 6,
-			                                            descendant[ index ] % 6,
-			                                            BOTTOMRIGHT,
-			                                            jump_forward,
-			                                            simulation_grid,
-			                                            blue_turn,
-			                                            blue_pool,
-			                                            blue_pool_size,
-			                                            red_pool,
-			                                            red_pool_size );
-			score += partial_score;
+			_skips[ line ] = skip;
+			_line_scores[ line ] = score_line( line, skip, _carries[ line ] );
 		}
+
+		_lines_score += _line_scores[ line ];
 	}
+}
+
+double HeuristicEvaluator::score() const
+{
+	double score = _lines_score;
+
+	int count_blue_po = count_cells( _board.blue_po );
+	int count_blue_bo = count_cells( _board.blue_bo );
+	int count_red_po = count_cells( _board.red_po );
+	int count_red_bo = count_cells( _board.red_bo );
+
+	int count_blue_central_po = count_cells( _board.blue_po & CENTER_MASK );
+	int count_blue_central_bo = count_cells( _board.blue_bo & CENTER_MASK );
+	int count_red_central_po = count_cells( _board.red_po & CENTER_MASK );
+	int count_red_central_bo = count_cells( _board.red_bo & CENTER_MASK );
+
+	int count_blue_border_po = count_cells( _board.blue_po & BORDER_MASK );
+	int count_blue_border_bo = count_cells( _board.blue_bo & BORDER_MASK );
+	int count_red_border_po = count_cells( _board.red_po & BORDER_MASK );
+	int count_red_border_bo = count_cells( _board.red_bo & BORDER_MASK );
 
 	int diff_po = 0;
 	int diff_bo = 0;
@@ -435,19 +431,12 @@ double heuristic_state( jbyte *const simulation_grid,
 	int diff_po_border = 0;
 	int diff_bo_border = 0;
 
-	int total_blue_bo = count_blue_bo;
-	for( int i = 0 ; i < blue_pool_size ; ++i )
-		if( blue_pool[i] == 2 )
-			++total_blue_bo;
-
-	int total_red_bo = count_red_bo;
-	for( int i = 0 ; i < red_pool_size ; ++i )
-		if( red_pool[i] == 2 )
-			++total_red_bo;
+	int total_blue_bo = count_blue_bo + _board.blue_pool.bo;
+	int total_red_bo = count_red_bo + _board.red_pool.bo;
 
 	int diff_total_bo = 0;
 
-	if( blue_turn )
+	if( _blue_turn )
 	{
 		diff_po = count_blue_po - count_red_po;
 		diff_bo = count_blue_bo - count_red_bo;
@@ -474,7 +463,7 @@ double heuristic_state( jbyte *const simulation_grid,
 		diff_total_bo = total_red_bo - total_blue_bo;
 	}
 
-	ALOG("diff_total_bo=%d\n"
+	TRACE_HEURISTIC("diff_total_bo=%d\n"
 			 "diff_bo=%d\n"
 			 "diff_bo_central=%d\n"
 			 "diff_bo_border=%d\n"
@@ -494,13 +483,13 @@ double heuristic_state( jbyte *const simulation_grid,
 	         + 9*diff_bo + 3*(diff_bo_central + diff_bo_border)
 	         + 3*diff_po + diff_po_central + diff_po_border;
 
-	ALOG("score before normalization=%.2f\n", score);
+	TRACE_HEURISTIC("score before normalization=%.2f\n", score);
 
 	// Score normalization [-1,1]
 	score = std::min( 400.0, std::max( -400.0, score ) ) / 400;
 
-	ALOG("score=%.3f\n", score);
-	ALOG("\n");
+	TRACE_HEURISTIC("score=%.3f\n", score);
+	TRACE_HEURISTIC("\n");
 
 	return score;
 }
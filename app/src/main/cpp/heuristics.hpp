@@ -5,27 +5,66 @@
 #ifndef POBO_HEURISTICS_HPP
 #define POBO_HEURISTICS_HPP
 
-#include <jni.h>
+#include "jni_types.hpp"
 #include <vector>
 #include "helpers.hpp"
+#include "bitboard.hpp"
+#include "pool.hpp"
 
+// Score of the alignment starting at (from_row, from_col) toward direction,
+// where alignments are the starting cells of alignments toward this direction.
 double compute_partial_score( int from_row,
                               int from_col,
                               Direction direction,
                               int& jump_forward,
                               jbyte * const simulation_grid,
+                              const Alignments &alignments,
                               jboolean blue_turn,
-                              jbyte * const blue_pool,
-                              jint& blue_pool_size,
-                              jbyte * const red_pool,
-                              jint& red_pool_size );
+                              bool do_current_player_has_bo_in_pool,
+                              bool do_opponent_has_bo_in_pool );
 
 double heuristic_state( jbyte *const simulation_grid,
                         jboolean blue_turn,
-                        jbyte *const blue_pool,
-                        jint blue_pool_size,
-                        jbyte *const red_pool,
-                        jint red_pool_size );
+                        const Pool &blue_pool,
+                        const Pool &red_pool );
+
+// Scanned lines: 6 rows, 6 columns, then 9 ascendant and 9 descendant diagonals (see heuristics.cpp)
+constexpr int NUMBER_LINES = 30;
+
+// heuristic_state kept as the partial scores of each scanned line, plus piece counts.
+// update rescans only the lines going through cells that changed since the last state.
+// Scores are always from the point of view of the player given to the constructor.
+class HeuristicEvaluator
+{
+	jbyte _grid[36];
+	Bitboard _board;
+	jboolean _blue_turn;
+	bool _do_current_player_has_bo_in_pool;
+	bool _do_opponent_has_bo_in_pool;
+	Alignments _alignments[4];
+
+	// Diagonal scans go on from one diagonal to the next, skipping the start cells covered by the previous
+	// alignment: _skips are these numbers of skipped start cells, _carries the ones left for the next diagonal.
+	double _line_scores[ NUMBER_LINES ];
+	int _skips[ NUMBER_LINES ];
+	int _carries[ NUMBER_LINES ];
+	double _lines_score;
+
+	double score_line( int line, int skip, int &carry );
+	void score_lines( bool all_lines, const bool ( &lines_to_score )[ NUMBER_LINES ] );
+
+public:
+	HeuristicEvaluator( const jbyte * const simulation_grid,
+	                    jboolean blue_turn,
+	                    const Pool &blue_pool,
+	                    const Pool &red_pool );
+
+	void update( const jbyte * const simulation_grid,
+	             const Pool &blue_pool,
+	             const Pool &red_pool );
+
+	double score() const;
+};
 
 std::vector<double> heuristic_promotions( jbyte *const simulation_grid,
                                           std::vector< std::vector<Position> > groups );
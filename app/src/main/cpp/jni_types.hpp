@@ -0,0 +1,18 @@
+#ifndef POBO_JNI_TYPES_HPP
+#define POBO_JNI_TYPES_HPP
+
+// The engine only needs JNI primitive types, so that host builds (POBO_HOST) can do without jni.h.
+// Definitions are the same as in jni.h.
+#ifdef POBO_HOST
+#include <cstdint>
+
+typedef int8_t jbyte;
+typedef uint8_t jboolean;
+typedef int32_t jint;
+typedef int64_t jlong;
+typedef double jdouble;
+#else
+#include <jni.h>
+#endif
+
+#endif //POBO_JNI_TYPES_HPP
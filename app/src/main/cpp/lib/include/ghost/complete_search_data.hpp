@@ -0,0 +1,129 @@
+/*
+ * GHOST (General meta-Heuristic Optimization Solving Tool) is a C++ framework
+ * designed to help developers to model and implement optimization problem
+ * solving. It contains a meta-heuristic solver aiming to solve any kind of
+ * combinatorial and optimization real-time problems represented by a CSP/COP/EF-CSP/EF-COP. 
+ *
+ * First developed to solve game-related optimization problems, GHOST can be used for
+ * any kind of applications where solving combinatorial and optimization problems. In
+ * particular, it had been designed to be able to solve not-too-complex problem instances
+ * within some milliseconds, making it very suitable for highly reactive or embedded systems.
+ * Please visit https://github.com/richoux/GHOST for further information.
+ *
+ * Copyright (C) 2014-2023 Florian Richoux
+ *
+ * This file is part of GHOST.
+ * GHOST is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * GHOST is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with GHOST. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "objective.hpp"
+
+namespace ghost
+{
+	/*
+	 * CompleteSearchData is the object containing inner data for one thread of complete_search.
+	 * Domains are bitsets over the indexes of each variable's full domain, with the same number
+	 * of words for every variable. They are filtered in place, and changed words are saved on
+	 * a trail to restore them when backtracking.
+	 */
+	struct CompleteSearchData
+	{
+		int words_per_domain;
+
+		// domains[ variable_id * words_per_domain + w ] holds the bits of indexes [64w, 64w+63]
+		std::vector<std::uint64_t> domains;
+
+		// (word position in domains, previous word) for each change of a domain
+		std::vector<std::pair<int, std::uint64_t> > trail;
+
+		// AC3 queue of (constraint, variable) entries, as indexes in the solver's list of entries,
+		// and a bitmap to know in constant time if an entry is already in the queue
+		std::deque<int> ac3queue;
+		std::vector<bool> queued;
+
+		// For complete_optimization: the objective's bound if it implements ObjectiveBound, and the
+		// Objective::cost value a subtree must be able to reach not to be pruned
+		const ObjectiveBound* objective_bound;
+		double cost_threshold;
+
+		CompleteSearchData( const std::vector<std::vector<int> >& full_domains, int number_entries )
+		: words_per_domain ( 1 ),
+		  queued ( number_entries, false ),
+		  objective_bound ( nullptr ),
+		  cost_threshold ( std::numeric_limits<double>::max() )
+		{
+			for( auto& domain : full_domains )
+				words_per_domain = std::max( words_per_domain, static_cast<int>( ( domain.size() + 63 ) / 64 ) );
+
+			domains.resize( full_domains.size() * words_per_domain, 0 );
+			for( int variable_id = 0; variable_id < static_cast<int>( full_domains.size() ); ++variable_id )
+				for( int index = 0; index < static_cast<int>( full_domains[ variable_id ].size() ); ++index )
+					domains[ variable_id * words_per_domain + ( index >> 6 ) ] |= std::uint64_t( 1 ) << ( index & 63 );
+		}
+
+		// Return the first index in the domain of variable_id not lower than index, or -1 if there is none
+		inline int next( int variable_id, int index ) const
+		{
+			int word_index = index >> 6;
+			if( word_index >= words_per_domain )
+				return -1;
+
+			const std::uint64_t* words = &domains[ variable_id * words_per_domain ];
+			std::uint64_t word = words[ word_index ] & ( ~std::uint64_t( 0 ) << ( index & 63 ) );
+			while( word == 0 )
+			{
+				if( ++word_index == words_per_domain )
+					return -1;
+				word = words[ word_index ];
+			}
+
+			return ( word_index << 6 ) + __builtin_ctzll( word );
+		}
+
+		inline bool is_empty( int variable_id ) const
+		{
+			for( int w = 0; w < words_per_domain; ++w )
+				if( domains[ variable_id * words_per_domain + w ] != 0 )
+					return false;
+			return true;
+		}
+
+		// Remove from the domain of variable_id the indexes of the word word_index set in mask
+		inline void remove( int variable_id, int word_index, std::uint64_t mask )
+		{
+			int position = variable_id * words_per_domain + word_index;
+			trail.emplace_back( position, domains[ position ] );
+			domains[ position ] &= ~mask;
+		}
+
+		// Undo all domain changes made since the trail had the size trail_size
+		inline void restore( std::size_t trail_size )
+		{
+			while( trail.size() > trail_size )
+			{
+				domains[ trail.back().first ] = trail.back().second;
+				trail.pop_back();
+			}
+		}
+	};
+}
@@ -455,4 +455,40 @@ namespace ghost
 			: Objective( variables, true, std::string( name ) )
 		{	}
 	};
+
+	/********************/
+	/** ObjectiveBound **/
+	/********************/
+	/*!
+	 * Optional interface for objective functions able to bound their cost on partial assignments.
+	 *
+	 * User-defined objective classes can inherit from both ghost::Minimize or ghost::Maximize and
+	 * ghost::ObjectiveBound. Solver::complete_optimization then prunes subtrees whose bound cannot
+	 * reach the cost of the solutions it already keeps. Objective functions that do not inherit
+	 * from ObjectiveBound are simply evaluated on every solution.
+	 *
+	 * \sa Objective, Solver::complete_optimization
+	 */
+	class ObjectiveBound
+	{
+	public:
+		//! Default virtual destructor.
+		virtual ~ObjectiveBound() = default;
+
+		/*!
+		 * Method returning the best cost, in the same direction as Objective::required_cost
+		 * (the highest one for maximization, the lowest one for minimization), that any complete
+		 * assignment extending the current partial assignment could reach.
+		 *
+		 * The bound must never be worse than the actual cost of such an assignment, otherwise
+		 * solutions may be missed.
+		 *
+		 * \param variables a const reference to the vector of raw pointers to variables in the
+		 * scope of the objective function.
+		 * \param last_assigned the model index of the last assigned variable: variables with an index
+		 * greater than last_assigned have no meaningful value yet.
+		 * \return A double bounding the cost of complete assignments.
+		 */
+		virtual double required_cost_bound( const std::vector<Variable*>& variables, int last_assigned ) const = 0;
+	};
 }
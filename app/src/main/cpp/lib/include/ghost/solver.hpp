@@ -42,6 +42,9 @@
 #include <iterator>
 #include <thread>
 #include <future>
+#include <atomic>
+#include <functional>
+#include <utility>
 
 #include "variable.hpp"
 #include "constraint.hpp"
@@ -51,6 +54,7 @@
 #include "model_builder.hpp"
 #include "options.hpp"
 #include "search_unit.hpp"
+#include "complete_search_data.hpp"
 
 #include "algorithms/variable_heuristic.hpp"
 #include "algorithms/variable_candidates_heuristic.hpp"
@@ -70,13 +74,7 @@
 
 #include "macros.hpp"
 
-// From https://manski.net/2012/05/logging-from-c-on-android/
-#include <android/log.h>
-//*
-#define ALOG(...)
-/*/
-#define ALOG( ... ) __android_log_print(ANDROID_LOG_INFO, "pobotag C++", __VA_ARGS__)
-//*/
+#include "trace.hpp"
 
 namespace ghost
 {
@@ -155,242 +153,354 @@ namespace ghost
 		// matrix_var_ctr[ variable_id ] = { constraint_id_1, ..., constraint_id_k }
 		std::vector<std::vector<int> > _matrix_var_ctr;
 
+		// For complete_search: full domain of each variable, indexed by the bits of CompleteSearchData's domains,
+		// and AC3 queue entries, i.e., (constraint id, variable id) pairs. Entries of a constraint start at
+		// _ac3_entry_offsets[ constraint_id ] and follow the order of its variables.
+		std::vector<std::vector<int> > _full_domains;
+		std::vector<std::pair<int, int> > _ac3_entries;
+		std::vector<int> _ac3_entry_offsets;
+
 		Options _options; // Options for the solver (see the struct Options).
 
 		// Prefilter domains before running the AC3 algorithm, if the model contains some unary constraints 
-		void prefiltering( std::vector<std::vector<int>> &domains )
+		void prefiltering( Model &model, CompleteSearchData &data )
 		{
-			ALOG( "prefiltering %d.", __LINE__ );
+			TRACE_SOLVER( "prefiltering %d.", __LINE__ );
 
-			for( auto &constraint: _model.constraints )
+			for( auto &constraint: model.constraints )
 			{
-				ALOG( "prefiltering %d.", __LINE__ );
+				TRACE_SOLVER( "prefiltering %d.", __LINE__ );
 				auto var_index = constraint->_variables_index;
 				if( var_index.size() == 1 )
 				{
-					ALOG( "prefiltering %d.", __LINE__ );
-					std::vector<int> values_to_remove;
+					TRACE_SOLVER( "prefiltering %d.", __LINE__ );
 					int index = var_index[ 0 ];
-					for( auto value: domains[ index ] )
+					for( int value_index = data.next( index, 0 ); value_index >= 0; value_index = data.next( index, value_index + 1 ))
 					{
-						ALOG( "prefiltering %d.", __LINE__ );
-						_model.variables[ index ].set_value( value );
+						TRACE_SOLVER( "prefiltering %d.", __LINE__ );
+						model.variables[ index ].set_value( _full_domains[ index ][ value_index ] );
 						if( constraint->error() > 0.0 )
-							values_to_remove.push_back( value );
+							data.remove( index, value_index >> 6, std::uint64_t( 1 ) << ( value_index & 63 ));
 					}
-
-					for( int value: values_to_remove )
-						domains[ index ].erase(
-										std::find( domains[ index ].begin(), domains[ index ].end(), value ));
 				}
 			}
+
+			// prefiltering is never undone
+			data.trail.clear();
 		}
 
-		// AC3 algorithm for complete_search. This method is handling the filtering, and return filtered domains.
-		// The vector of vector 'domains' is passed by copy on purpose.
+		// Methods of complete_search work on the model they are given, to run on several threads with one model per thread.
+
+		// AC3 algorithm for complete_search. This method is filtering domains in data, and return false if a domain gets empty.
+		// Removed values are pushed on data's trail: callers restore domains once the subtree is explored.
 		// The value of variable[ index_v ] has already been set before the call
-		std::vector<std::vector<int>>
-		ac3_filtering( int index_v, std::vector<std::vector<int>> domains )
+		bool ac3_filtering( Model &model, int index_v, CompleteSearchData &data )
 		{
-			ALOG( "ac3_filtering %d.", __LINE__ );
-			// queue of (constraint id, variable id)
-			std::deque<std::pair<int, int>> ac3queue;
-
-			for( int constraint_id: _matrix_var_ctr[ index_v ] )
-				for( int variable_id: _model.constraints[ constraint_id ]->_variables_index )
+			TRACE_SOLVER( "ac3_filtering %d.", __LINE__ );
+			auto enqueue = [&]( int constraint_id, int variable_position )
+			{
+				int entry = _ac3_entry_offsets[ constraint_id ] + variable_position;
+				if( !data.queued[ entry ] )
 				{
-					if( variable_id <= index_v )
-						continue;
-
-					ALOG( "ac3_filtering %d.", __LINE__ );
-					ac3queue.push_back( std::make_pair( constraint_id, variable_id ));
+					TRACE_SOLVER( "ac3_filtering %d.", __LINE__ );
+					data.queued[ entry ] = true;
+					data.ac3queue.push_back( entry );
 				}
+			};
+
+			for( int constraint_id: _matrix_var_ctr[ index_v ] )
+			{
+				auto &scope = model.constraints[ constraint_id ]->_variables_index;
+				for( int position = 0; position < static_cast<int>( scope.size()); ++position )
+					if( scope[ position ] > index_v )
+						enqueue( constraint_id, position );
+			}
 
-			std::vector<int> values_to_remove;
-			while( !ac3queue.empty())
+			while( !data.ac3queue.empty())
 			{
-				ALOG( "ac3_filtering %d.", __LINE__ );
-				int constraint_id = ac3queue.front().first;
-				int variable_id = ac3queue.front().second;
-				ac3queue.pop_front();
-				values_to_remove.clear();
-				for( auto value: domains[ variable_id ] )
+				TRACE_SOLVER( "ac3_filtering %d.", __LINE__ );
+				int entry = data.ac3queue.front();
+				data.ac3queue.pop_front();
+				data.queued[ entry ] = false;
+				int constraint_id = _ac3_entries[ entry ].first;
+				int variable_id = _ac3_entries[ entry ].second;
+
+				for( int word_index = 0; word_index < data.words_per_domain; ++word_index )
 				{
-					ALOG( "ac3_filtering %d.", __LINE__ );
-					_model.variables[ variable_id ].set_value( value );
-					if( !has_support( constraint_id, variable_id, value, index_v, domains ))
+					std::uint64_t word = data.domains[ variable_id * data.words_per_domain + word_index ];
+					std::uint64_t unsupported = 0;
+					for( ; word != 0; word &= word - 1 )
 					{
-						ALOG( "ac3_filtering %d.", __LINE__ );
-						values_to_remove.push_back( value );
-						for( int c_id: _matrix_var_ctr[ variable_id ] )
+						TRACE_SOLVER( "ac3_filtering %d.", __LINE__ );
+						int value_index = ( word_index << 6 ) + __builtin_ctzll( word );
+						model.variables[ variable_id ].set_value( _full_domains[ variable_id ][ value_index ] );
+						if( !has_support( model, constraint_id, variable_id, index_v, data ))
 						{
-							ALOG( "ac3_filtering %d.", __LINE__ );
-							if( c_id == constraint_id )
-								continue;
-
-							for( int v_id: _model.constraints[ c_id ]->_variables_index )
+							TRACE_SOLVER( "ac3_filtering %d.", __LINE__ );
+							unsupported |= word & -word;
+							for( int c_id: _matrix_var_ctr[ variable_id ] )
 							{
-								ALOG( "ac3_filtering %d.", __LINE__ );
-								if( v_id <= index_v || v_id == variable_id )
+								TRACE_SOLVER( "ac3_filtering %d.", __LINE__ );
+								if( c_id == constraint_id )
 									continue;
 
-								if( std::find_if( ac3queue.begin(),
-								                  ac3queue.end(),
-								                  [&]( auto &elem )
-								                  { return elem.first == c_id && elem.second == v_id; } ) ==
-								    ac3queue.end())
-								{
-									ALOG( "ac3_filtering %d.", __LINE__ );
-									ac3queue.push_back( std::make_pair( c_id, v_id ));
-								}
+								auto &scope = model.constraints[ c_id ]->_variables_index;
+								for( int position = 0; position < static_cast<int>( scope.size()); ++position )
+									if( scope[ position ] > index_v && scope[ position ] != variable_id )
+										enqueue( c_id, position );
 							}
 						}
 					}
-				}
 
-				for( int value: values_to_remove )
-					domains[ variable_id ].erase(
-									std::find( domains[ variable_id ].begin(), domains[ variable_id ].end(), value ));
+					if( unsupported != 0 )
+						data.remove( variable_id, word_index, unsupported );
+				}
 
-				ALOG( "ac3_filtering %d.", __LINE__ );
+				TRACE_SOLVER( "ac3_filtering %d.", __LINE__ );
 				// once a domain is empty, no need to go further
-				if( domains[ variable_id ].empty())
-					return domains;
+				if( data.is_empty( variable_id ))
+				{
+					for( int pending: data.ac3queue )
+						data.queued[ pending ] = false;
+					data.ac3queue.clear();
+					return false;
+				}
 			}
 
-			ALOG( "ac3_filtering %d.", __LINE__ );
-			return domains;
+			TRACE_SOLVER( "ac3_filtering %d.", __LINE__ );
+			return true;
 		}
 
-		// Method called by ac3_filtering, to compute if variable_id assigned to value has some support for the constraint
+		// Method called by ac3_filtering, to compute if variable_id assigned to its current value has some support for the constraint
 		// constraint_id, but testing iteratively all combination of values for free variables until finding a local solution,
 		// or exhausting all possibilities. Return true if and only if a support exists. 
 		// Values of variable[ index_v ] and variable[ variable_id ] have already been set before the call
-		bool has_support( int constraint_id, int variable_id, int value, int index_v,
-		                  const std::vector<std::vector<int>> &domains )
+		bool has_support( Model &model, int constraint_id, int variable_id, int index_v, const CompleteSearchData &data )
 		{
-			ALOG( "has_support %d.", __LINE__ );
+			TRACE_SOLVER( "has_support %d.", __LINE__ );
 			std::vector<int> constraint_scope;
-			for( auto var_index: _model.constraints[ constraint_id ]->_variables_index )
+			for( auto var_index: model.constraints[ constraint_id ]->_variables_index )
 				if( var_index > index_v && var_index != variable_id )
 					constraint_scope.push_back( var_index );
 
-			ALOG( "has_support %d.", __LINE__ );
+			TRACE_SOLVER( "has_support %d.", __LINE__ );
 			// Case where there are no free variables
 			if( constraint_scope.empty())
-				return _model.constraints[ constraint_id ]->error() == 0.0;
+				return model.constraints[ constraint_id ]->error() == 0.0;
 
-			ALOG( "has_support %d.", __LINE__ );
-			// From here, there are some free variables to assign
-			std::vector<int> indexes( constraint_scope.size() + 1, 0 );
-			int fake_index = static_cast<int>( indexes.size()) - 1;
+			TRACE_SOLVER( "has_support %d.", __LINE__ );
+			// From here, there are some free variables to assign, through the indexes of their domain values
+			int scope_size = static_cast<int>( constraint_scope.size());
+			std::vector<int> indexes( scope_size );
+			for( int i = 0; i < scope_size; ++i )
+			{
+				indexes[ i ] = data.next( constraint_scope[ i ], 0 );
+				if( indexes[ i ] < 0 )
+					return false;
+			}
 
-			while( indexes[ fake_index ] == 0 )
+			while( true )
 			{
-				ALOG( "has_support %d.", __LINE__ );
-				for( int i = 0; i < fake_index; ++i )
+				TRACE_SOLVER( "has_support %d.", __LINE__ );
+				for( int i = 0; i < scope_size; ++i )
 				{
-					ALOG( "has_support %d.", __LINE__ );
+					TRACE_SOLVER( "has_support %d.", __LINE__ );
 					int assignment_index = constraint_scope[ i ];
-					int assignment_value = domains[ assignment_index ][ indexes[ i ]];
-					_model.variables[ assignment_index ].set_value( assignment_value );
+					model.variables[ assignment_index ].set_value( _full_domains[ assignment_index ][ indexes[ i ]] );
 				}
 
-				if( _model.constraints[ constraint_id ]->error() == 0.0 )
+				if( model.constraints[ constraint_id ]->error() == 0.0 )
 					return true;
-				else
+
+				TRACE_SOLVER( "has_support %d.", __LINE__ );
+				// next combination, the first free variable changing first
+				int index = 0;
+				for( ; index < scope_size; ++index )
 				{
-					ALOG( "has_support %d.", __LINE__ );
-					bool changed;
-					int index = 0;
-					do
-					{
-						ALOG( "has_support %d.", __LINE__ );
-						changed = false;
-						++indexes[ index ];
-						if( index < fake_index &&
-						    indexes[ index ] >= static_cast<int>( domains[ constraint_scope[ index ]].size()))
-						{
-							ALOG( "has_support %d.", __LINE__ );
-							indexes[ index ] = 0;
-							changed = true;
-							++index;
-						}
-					}
-					while( changed );
+					indexes[ index ] = data.next( constraint_scope[ index ], indexes[ index ] + 1 );
+					if( indexes[ index ] >= 0 )
+						break;
+					indexes[ index ] = data.next( constraint_scope[ index ], 0 );
+				}
+
+				if( index == scope_size )
+				{
+					TRACE_SOLVER( "has_support %d.", __LINE__ );
+					return false;
 				}
 			}
+		}
 
-			ALOG( "has_support %d.", __LINE__ );
-			return false;
+		// True if no complete assignment extending the assignment of variables 0 to last_assigned can reach
+		// data.cost_threshold, according to the objective's bound. Always false without ObjectiveBound.
+		bool cannot_improve( Model &model, int last_assigned, const CompleteSearchData &data ) const
+		{
+			if( data.objective_bound == nullptr || last_assigned + 1 >= static_cast<int>( model.variables.size()))
+				return false;
+
+			double bound = data.objective_bound->required_cost_bound( model.objective->_variables, last_assigned );
+			// same direction as Objective::cost, which GHOST always minimizes
+			if( model.objective->is_maximization())
+				bound = -bound;
+
+			return bound > data.cost_threshold;
+		}
+
+		// Give the solution currently assigned in model to visitor, with its cost. solution is the buffer holding it.
+		// Return false if visitor asks to stop the search.
+		template<typename Visitor>
+		bool visit_solution( Model &model, std::vector<int> &solution, Visitor &visitor )
+		{
+			for( int i = 0; i < static_cast<int>( solution.size()); ++i )
+				solution[ i ] = model.variables[ i ].get_value();
+
+			double cost = model.objective->cost();
+			if( model.objective->is_maximization())
+				cost = -cost;
+
+			TRACE_SOLVER( "Solution: piece=%d, position=(%d,%d)", solution[ 0 ], solution[ 1 ],
+			      solution[ 2 ] );
+			TRACE_SOLVER( "Cost=%.2f\n\n", cost );
+			return visitor( static_cast<const std::vector<int>&>( solution ), cost );
 		}
 
-		// Recursive call of complete_search. Search for all solutions of the problem instance.
-		// index_v is the index of the last variable assigned. Return the vector of some found solutions.
+		// Recursive call of complete_search. Search for all solutions of the problem instance, given to visitor
+		// as they are found. index_v is the index of the last variable assigned. Return false if visitor asks to stop.
+		// Domains in data are given back as they were before the call.
 		// The value of variable[ index_v ] has already been set before the call
-		std::vector<std::vector<int>>
-		complete_search( int index_v, std::vector<std::vector<int>> domains )
+		template<typename Visitor>
+		bool complete_search( Model &model, int index_v, CompleteSearchData &data, std::vector<int> &solution, Visitor &visitor )
 		{
 			// should never be called
-			if( index_v >= _model.variables.size())
-				return std::vector<std::vector<int>>();
+			if( index_v >= model.variables.size())
+				return true;
 
-			ALOG( "complete_search rec %d.", __LINE__ );
-			std::vector<std::vector<int>> new_domains;
-			if( index_v > 0 )
+			TRACE_SOLVER( "complete_search rec %d.", __LINE__ );
+			std::size_t trail_size = data.trail.size();
+			// index_v == 0: domains are already filtered
+			if( index_v > 0 && !ac3_filtering( model, index_v, data ))
 			{
-				ALOG( "complete_search rec %d.", __LINE__ );
-				new_domains = ac3_filtering( index_v, domains );
-				auto empty_domain = std::find_if( new_domains.cbegin(), new_domains.cend(),
-				                                  [&]( auto &domain )
-				                                  { return domain.empty(); } );
-
-				ALOG( "complete_search rec %d.", __LINE__ );
-				if( empty_domain != new_domains.cend())
-					return std::vector<std::vector<int>>();
-			}
-			else
-			{
-				ALOG( "complete_search rec %d.", __LINE__ );
-				new_domains = domains; // already filtered
+				TRACE_SOLVER( "complete_search rec %d.", __LINE__ );
+				data.restore( trail_size );
+				return true;
 			}
 
 			int next_var = index_v + 1;
-			std::vector<std::vector<int>> solutions;
+			bool go_on = true;
 
-			ALOG( "complete_search rec %d. next_var=%d, new_domains[next_var].size=%d", __LINE__,
-			      next_var, new_domains[ next_var ].size());
+			TRACE_SOLVER( "complete_search rec %d. next_var=%d", __LINE__, next_var );
 
-			for( auto value: new_domains[ next_var ] )
+			// filtering below next_var never changes next_var's domain
+			for( int value_index = data.next( next_var, 0 ); go_on && value_index >= 0; value_index = data.next( next_var, value_index + 1 ))
 			{
-				ALOG( "complete_search rec %d.", __LINE__ );
-				_model.variables[ next_var ].set_value( value );
+				TRACE_SOLVER( "complete_search rec %d.", __LINE__ );
+				model.variables[ next_var ].set_value( _full_domains[ next_var ][ value_index ] );
 
 				// last variable
-				if( next_var == _model.variables.size() - 1 )
-				{
-					ALOG( "complete_search rec %d.", __LINE__ );
-					std::vector<int> solution;
-					for( auto &var: _model.variables )
-						solution.emplace_back( var.get_value());
-
-					solutions.emplace_back( solution );
-				}
+				if( next_var == model.variables.size() - 1 )
+					go_on = visit_solution( model, solution, visitor );
 				else // not the last variable: recursive call
-				{
-					ALOG( "complete_search rec %d.", __LINE__ );
-					auto partial_solutions = complete_search( next_var, new_domains );
-					if( !partial_solutions.empty())
-						std::copy_if( partial_solutions.begin(),
-						              partial_solutions.end(),
-						              std::back_inserter( solutions ),
-						              [&]( auto &solution )
-						              { return !solution.empty(); } );
-				}
+					if( !cannot_improve( model, next_var, data ))
+						go_on = complete_search( model, next_var, data, solution, visitor );
+			}
+
+			TRACE_SOLVER( "complete_search rec %d.", __LINE__ );
+			data.restore( trail_size );
+			return go_on;
+		}
+
+		// Part of complete_search where the two first variables are assigned to first_value and second_value.
+		// data holds the domains filtered by ac3_filtering once the first variable has been assigned.
+		// Solutions are given to visitor in the same order as a sequential complete_search.
+		template<typename Visitor>
+		bool complete_search_subtree( Model &model,
+		                              int first_value,
+		                              int second_value,
+		                              CompleteSearchData &data,
+		                              std::vector<int> &solution,
+		                              Visitor &visitor )
+		{
+			TRACE_SOLVER( "complete_search_subtree %d, first_value=%d, second_value=%d.", __LINE__, first_value, second_value );
+			model.variables[ 0 ].set_value( first_value );
+			model.variables[ 1 ].set_value( second_value );
+
+			if( model.variables.size() == 2 )
+				return visit_solution( model, solution, visitor );
+			else
+				if( cannot_improve( model, 1, data ))
+					return true;
+				else
+					return complete_search( model, 1, data, solution, visitor );
+		}
+
+		// Give all solutions to visitor, on the calling thread and with _model, until visitor asks to stop.
+		// data must come from init_complete_search. Return false if visitor asked to stop.
+		template<typename Visitor>
+		bool stream_solutions( CompleteSearchData &data, Visitor &visitor )
+		{
+			std::vector<int> solution( _model.variables.size());
+			bool go_on = true;
+			for( int value_index = data.next( 0, 0 ); go_on && value_index >= 0; value_index = data.next( 0, value_index + 1 ))
+			{
+				TRACE_SOLVER( "stream_solutions %d.", __LINE__ );
+				int first_value = _full_domains[ 0 ][ value_index ];
+				_model.variables[ 0 ].set_value( first_value );
+				if( !cannot_improve( _model, 0, data ) && ac3_filtering( _model, 0, data ))
+					for( int second_index = data.next( 1, 0 ); go_on && second_index >= 0; second_index = data.next( 1, second_index + 1 ))
+						go_on = complete_search_subtree( _model, first_value, _full_domains[ 1 ][ second_index ], data, solution, visitor );
+
+				data.restore( 0 );
+			}
+
+			return go_on;
+		}
+
+		// Build the model and data of complete_search, and prefilter domains.
+		CompleteSearchData init_complete_search()
+		{
+			_model = _model_builder.build_model();
+
+			_full_domains.clear();
+			for( auto &var: _model.variables )
+				_full_domains.emplace_back( var.get_full_domain());
+
+			TRACE_SOLVER( "complete_search %d.", __LINE__ );
+			_matrix_var_ctr.resize( _model.variables.size());
+			for( int variable_id = 0;
+			     variable_id < static_cast<int>( _model.variables.size()); ++variable_id )
+			{
+				_matrix_var_ctr[ variable_id ] = std::vector<int>();
+				for( int constraint_id = 0;
+				     constraint_id < static_cast<int>( _model.constraints.size()); ++constraint_id )
+					if( _model.constraints[ constraint_id ]->has_variable( variable_id ))
+						_matrix_var_ctr[ variable_id ].push_back( constraint_id );
 			}
 
-			ALOG( "complete_search rec %d.", __LINE__ );
-			return solutions;
+			_ac3_entries.clear();
+			_ac3_entry_offsets.clear();
+			for( int constraint_id = 0;
+			     constraint_id < static_cast<int>( _model.constraints.size()); ++constraint_id )
+			{
+				_ac3_entry_offsets.push_back( static_cast<int>( _ac3_entries.size()));
+				for( int variable_id: _model.constraints[ constraint_id ]->_variables_index )
+					_ac3_entries.emplace_back( constraint_id, variable_id );
+			}
+
+			TRACE_SOLVER( "complete_search %d.", __LINE__ );
+			CompleteSearchData data( _full_domains, static_cast<int>( _ac3_entries.size()));
+			prefiltering( _model, data );
+			TRACE_SOLVER( "complete_search %d.", __LINE__ );
+			return data;
+		}
+
+		// True if prefiltering left a variable without values
+		bool has_empty_domain( const CompleteSearchData &data ) const
+		{
+			for( int variable_id = 0;
+			     variable_id < static_cast<int>( _model.variables.size()); ++variable_id )
+				if( data.is_empty( variable_id ))
+					return true;
+			return false;
 		}
 
 	public:
@@ -939,7 +1049,9 @@ namespace ghost
 		 * maximization problem, GHOST will automatically convert it into a minimization problem.
 		 *
 		 * Finally, options to change the solver behaviors (parallel runs, user-defined solution
-		 * printing) can be given as a last parameter.
+		 * printing) can be given as a last parameter. With parallel runs, the search tree is split
+		 * according to the values of the two first variables, and explored by up to
+		 * Options::number_threads threads. Solutions come in the same order as in a sequential search.
 		 *
 		 * \param final_costs a reference to a vector of double to get the errors of all solutions for 
 		 * satisfaction problems, or their objective function value for optimization problems 
@@ -957,77 +1069,91 @@ namespace ghost
 			// init data
 			bool solutions_exist = false;
 			_options = options;
-			ALOG( "complete_search %d.", __LINE__ );
+			TRACE_SOLVER( "complete_search %d.", __LINE__ );
 
-			_model = _model_builder.build_model();
+			CompleteSearchData data = init_complete_search();
+			if( has_empty_domain( data ))
+				return false;
 
-			std::vector<std::vector<int> > domains;
-			for( auto &var: _model.variables )
-				domains.emplace_back( var.get_full_domain());
+			// The search tree is split into subtrees, one per pair of values of the two first variables,
+			// in the sequential search order. Threads take the next subtree to explore until none are left.
+			std::vector<int> first_values;
+			std::vector<std::vector<std::uint64_t>> first_domains;
+			std::vector<std::pair<int, int>> subtrees; // (index in first_values and first_domains, second value)
 
-			ALOG( "complete_search %d.", __LINE__ );
-			_matrix_var_ctr.resize( _model.variables.size());
-			for( int variable_id = 0;
-			     variable_id < static_cast<int>( _model.variables.size()); ++variable_id )
+			for( int value_index = data.next( 0, 0 ); value_index >= 0; value_index = data.next( 0, value_index + 1 ))
 			{
-				_matrix_var_ctr[ variable_id ] = std::vector<int>();
-				for( int constraint_id = 0;
-				     constraint_id < static_cast<int>( _model.constraints.size()); ++constraint_id )
-					if( _model.constraints[ constraint_id ]->has_variable( variable_id ))
-						_matrix_var_ctr[ variable_id ].push_back( constraint_id );
+				TRACE_SOLVER( "complete_search %d.", __LINE__ );
+				_model.variables[ 0 ].set_value( _full_domains[ 0 ][ value_index ] );
+				if( ac3_filtering( _model, 0, data ))
+				{
+					first_values.push_back( _full_domains[ 0 ][ value_index ] );
+					first_domains.push_back( data.domains );
+					for( int second_index = data.next( 1, 0 ); second_index >= 0; second_index = data.next( 1, second_index + 1 ))
+						subtrees.emplace_back( static_cast<int>( first_values.size()) - 1, _full_domains[ 1 ][ second_index ] );
+				}
+				data.restore( 0 );
 			}
 
-			ALOG( "complete_search %d.", __LINE__ );
-			prefiltering( domains );
-			ALOG( "complete_search %d.", __LINE__ );
+			int number_subtrees = static_cast<int>( subtrees.size());
+			std::vector<std::vector<double>> subtree_costs( number_subtrees );
+			std::vector<std::vector<std::vector<int>>> subtree_solutions( number_subtrees );
+			std::atomic<int> next_subtree( 0 );
 
-			for( int value: domains[ 0 ] )
+			auto explore = [&]( Model &model )
 			{
-				ALOG( "complete_search %d.", __LINE__ );
-				_model.variables[ 0 ].set_value( value );
-				auto new_domains = ac3_filtering( 0, domains );
-				auto empty_domain = std::find_if( new_domains.cbegin(), new_domains.cend(),
-				                                  [&]( auto &domain )
-				                                  { return domain.empty(); } );
-
-				if( empty_domain == new_domains.cend() )
+				CompleteSearchData thread_data( _full_domains, static_cast<int>( _ac3_entries.size()));
+				std::vector<int> solution( model.variables.size());
+				for( int subtree = next_subtree++; subtree < number_subtrees; subtree = next_subtree++ )
 				{
-					ALOG( "complete_search %d.", __LINE__ );
-					std::vector<std::vector<int>> partial_solutions = complete_search( 0, new_domains );
-					ALOG( "complete_search %d, partial_solutions.size=%d.", __LINE__,
-					      partial_solutions.size() );
-
-					for( auto &solution: partial_solutions )
+					auto collect = [&]( const std::vector<int> &found, double cost )
 					{
-						ALOG( "complete_search %d, solution.size=%d.", __LINE__, solution.size() );
-						if( !solution.empty() )
-						{
-							solutions_exist = true;
-							for( int i = 1; i < static_cast<int>( solution.size()); ++i )
-							{
-								ALOG( "complete_search %d.", __LINE__ );
-								_model.variables[ i ].set_value( solution[ i ] );
-							}
-
-							ALOG( "complete_search %d.", __LINE__ );
-							double cost = _model.objective->cost();
-							ALOG( "complete_search %d.", __LINE__ );
-							if( _model.objective->is_maximization())
-								cost = -cost;
-
-							ALOG( "Solution: piece=%d, position=(%d,%d)", solution[ 0 ], solution[ 1 ],
-							      solution[ 2 ] );
-							ALOG( "Cost=%.2f\n\n", cost );
-							final_costs.push_back( cost );
-							final_solutions.emplace_back( solution );
-						}
-						else
-							ALOG( "complete_search %d, empty solution.", __LINE__ );
-					}
+						subtree_costs[ subtree ].push_back( cost );
+						subtree_solutions[ subtree ].push_back( found );
+						return true;
+					};
+
+					thread_data.domains = first_domains[ subtrees[ subtree ].first ];
+					complete_search_subtree( model,
+					                         first_values[ subtrees[ subtree ].first ],
+					                         subtrees[ subtree ].second,
+					                         thread_data,
+					                         solution,
+					                         collect );
 				}
+			};
+
+			int number_threads = _options.parallel_runs ? std::min( _options.number_threads, number_subtrees ) : 1;
+			TRACE_SOLVER( "complete_search %d, number_subtrees=%d, number_threads=%d.", __LINE__,
+			      number_subtrees, number_threads );
+
+			// like in fast_search, each thread has its own model, built here
+			std::vector<Model> models;
+			models.reserve( std::max( 0, number_threads - 1 ));
+			std::vector<std::thread> threads;
+			for( int i = 1; i < number_threads; ++i )
+			{
+				models.emplace_back( _model_builder.build_model());
+				threads.emplace_back( explore, std::ref( models.back()));
+			}
+
+			explore( _model );
+			for( auto &thread: threads )
+				thread.join();
+
+			// merge in subtree order, so that outputs do not depend on the number of threads
+			for( int subtree = 0; subtree < number_subtrees; ++subtree )
+			{
+				if( !subtree_solutions[ subtree ].empty() )
+					solutions_exist = true;
+
+				std::move( subtree_costs[ subtree ].begin(), subtree_costs[ subtree ].end(),
+				           std::back_inserter( final_costs ));
+				std::move( subtree_solutions[ subtree ].begin(), subtree_solutions[ subtree ].end(),
+				           std::back_inserter( final_solutions ));
 			}
 
-			ALOG( "complete_search %d, solutions_exist=%d.", __LINE__, solutions_exist );
+			TRACE_SOLVER( "complete_search %d, solutions_exist=%d.", __LINE__, solutions_exist );
 
 			// need to reassigned the variables value to solutions one by one
 			//std::cout << _options.print->print_candidate( _model.variables ).str();
@@ -1053,6 +1179,145 @@ namespace ghost
 			return complete_search( final_costs, final_solutions, options );
 		}
 
+		/*!
+		 * Method to look for all solutions of a given CSP/COP/EF-CSP/EF-COP model, handing them
+		 * one by one to a visitor instead of storing them.
+		 *
+		 * The visitor is called as visitor( solution, cost ) for each solution, as soon as it is
+		 * found and in the same order as the other Solver::complete_search methods. solution is a
+		 * const reference to a vector of integers that is only valid during the call, and cost is
+		 * the same error/cost as in final_costs. The visitor returns true to continue the search,
+		 * or false to stop it.\n
+		 * Memory usage does not depend on the number of solutions. Solutions are found by the
+		 * calling thread only: parallel runs in options are ignored.
+		 *
+		 * \param visitor a callable object taking a const std::vector<int>& and a double, and
+		 * returning a bool.
+		 * \param options a reference to an Options object containing options such as parallel runs,
+		 * a solution printer, etc.
+		 * \return True if and only if the visitor has been called at least once.
+		 */
+		template<typename Visitor>
+		bool complete_search( Visitor &&visitor, Options &options )
+		{
+			bool solutions_exist = false;
+			_options = options;
+			TRACE_SOLVER( "complete_search visitor %d.", __LINE__ );
+
+			CompleteSearchData data = init_complete_search();
+			if( has_empty_domain( data ))
+				return false;
+
+			auto visit = [&]( const std::vector<int> &solution, double cost )
+			{
+				solutions_exist = true;
+				return static_cast<bool>( visitor( solution, cost ));
+			};
+
+			stream_solutions( data, visit );
+			TRACE_SOLVER( "complete_search visitor %d, solutions_exist=%d.", __LINE__, solutions_exist );
+			return solutions_exist;
+		}
+
+		/*!
+		 * Call Solver::complete_search with a visitor and default options.
+		 *
+		 * \param visitor a callable object taking a const std::vector<int>& and a double, and
+		 * returning a bool.
+		 * \return True if and only if the visitor has been called at least once.
+		 */
+		template<typename Visitor>
+		bool complete_search( Visitor &&visitor )
+		{
+			Options options;
+			return complete_search( std::forward<Visitor>( visitor ), options );
+		}
+
+		/*!
+		 * Method to look for the best solutions of a COP/EF-COP model by branch and bound, rather
+		 * than scoring all of them like Solver::complete_search.
+		 *
+		 * The method keeps the number_best best solutions found so far, plus the ones tied with
+		 * the worst of them, so that callers can randomly pick among ties. With number_best = 1, it
+		 * returns all optimal solutions. Solutions and costs are given in the same order and with
+		 * the same cost convention as Solver::complete_search.\n
+		 * If the model objective also inherits from ghost::ObjectiveBound, subtrees that cannot
+		 * reach the cost of the worst kept solution are pruned. Otherwise, all solutions are still
+		 * evaluated, but only the best ones are stored. The search runs on the calling thread:
+		 * parallel runs in options are ignored.
+		 *
+		 * \param number_best the number of best solutions to keep, ties excepted.
+		 * \param best_costs a reference to a vector of double to get the costs of the best solutions.
+		 * This vector and best_solutions are cleared first.
+		 * \param best_solutions a reference to a vector of vector of integers, containing the best
+		 * solutions.
+		 * \param options a reference to an Options object containing options such as parallel runs,
+		 * a solution printer, etc.
+		 * \return True if and only a solution of the problem exists.
+		 */
+		bool complete_optimization( int number_best,
+		                            std::vector<double> &best_costs,
+		                            std::vector<std::vector<int>> &best_solutions,
+		                            Options &options )
+		{
+			_options = options;
+			best_costs.clear();
+			best_solutions.clear();
+			TRACE_SOLVER( "complete_optimization %d.", __LINE__ );
+
+			CompleteSearchData data = init_complete_search();
+			if( number_best <= 0 || has_empty_domain( data ))
+				return false;
+
+			data.objective_bound = dynamic_cast<const ObjectiveBound*>( _model.objective.get());
+			bool is_maximization = _model.objective->is_maximization();
+
+			// ranks are Objective::cost values: the lower the better
+			std::vector<double> ranks;
+			std::vector<double> sorted_ranks;
+			auto keep_best = [&]( const std::vector<int> &solution, double cost )
+			{
+				double rank = is_maximization ? -cost : cost;
+				if( static_cast<int>( ranks.size()) >= number_best && rank > data.cost_threshold )
+					return true;
+
+				ranks.push_back( rank );
+				best_costs.push_back( cost );
+				best_solutions.push_back( solution );
+
+				if( static_cast<int>( ranks.size()) >= number_best )
+				{
+					sorted_ranks = ranks;
+					std::nth_element( sorted_ranks.begin(), sorted_ranks.begin() + ( number_best - 1 ), sorted_ranks.end());
+					data.cost_threshold = sorted_ranks[ number_best - 1 ];
+
+					int kept = 0;
+					for( int i = 0; i < static_cast<int>( ranks.size()); ++i )
+						if( ranks[ i ] <= data.cost_threshold )
+						{
+							if( kept != i )
+							{
+								ranks[ kept ] = ranks[ i ];
+								best_costs[ kept ] = best_costs[ i ];
+								best_solutions[ kept ] = std::move( best_solutions[ i ] );
+							}
+							++kept;
+						}
+
+					ranks.resize( kept );
+					best_costs.resize( kept );
+					best_solutions.resize( kept );
+				}
+
+				return true;
+			};
+
+			stream_solutions( data, keep_best );
+
+			TRACE_SOLVER( "complete_optimization %d, number of kept solutions=%d.", __LINE__, ranks.size() );
+			return !ranks.empty();
+		}
+
 		/*!
 		 * Method to get the variables in the model. This method can be handy in some situations,
 		 * if users do not know what the variables composing their problem instance are, and need 
@@ -0,0 +1,449 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <map>
+
+#include "mcts.hpp"
+#include "helpers.hpp"
+#include "heuristics.hpp"
+#include "symmetry.hpp"
+#include "transposition_table.hpp"
+#include "zobrist.hpp"
+
+// std::atomic<double> has no fetch_add before C++20
+static void atomic_add( std::atomic<double> &value, double increment )
+{
+	double current = value.load();
+	while( !value.compare_exchange_weak( current, current + increment ) )
+		;
+}
+
+NodePool::NodePool()
+	: _size( 0 )
+{ }
+
+int NodePool::allocate()
+{
+	std::lock_guard<std::mutex> lock( _allocation_lock );
+
+	int id = _size.load();
+	if( id >= MAX_CHUNKS * CHUNK_SIZE )
+		return -1;
+
+	if( !_chunks[ id >> CHUNK_BITS ] )
+		_chunks[ id >> CHUNK_BITS ].reset( new Node[ CHUNK_SIZE ] );
+
+	_size.store( id + 1 );
+	return id;
+}
+
+void NodePool::clear()
+{
+	_size.store( 0 );
+}
+
+MCTS::MCTS( WorkerPool &workers,
+            int number_preselected_actions,
+            bool expansions_with_ghost,
+            int first_n_strategy,
+            int playout_depth,
+            int action_masking_time,
+            double discount_score,
+            int number_threads )
+	: _workers( workers ),
+	  _number_preselected_actions( number_preselected_actions ),
+	  _expansions_with_ghost( expansions_with_ghost ),
+	  _first_n_strategy( first_n_strategy ),
+	  _playout_depth( playout_depth ),
+	  _action_masking_time( action_masking_time ),
+	  _discount_score( discount_score ),
+	  _number_threads( std::max( 1, number_threads ) )
+{ }
+
+bool MCTS::has_parameters( int number_preselected_actions,
+                           bool expansions_with_ghost,
+                           int first_n_strategy,
+                           int playout_depth,
+                           int action_masking_time,
+                           double discount_score,
+                           int number_threads ) const
+{
+	return _number_preselected_actions == number_preselected_actions
+	       && _expansions_with_ghost == expansions_with_ghost
+	       && _first_n_strategy == first_n_strategy
+	       && _playout_depth == playout_depth
+	       && _action_masking_time == action_masking_time
+	       && _discount_score == discount_score
+	       && _number_threads == std::max( 1, number_threads );
+}
+
+// Must be called with the parent's expansion lock, or before the search threads start
+int MCTS::create_node( const State &state, const Move &move, int parent, int virtual_losses )
+{
+	int id = _nodes.allocate();
+	if( id == -1 )
+		return -1;
+
+	Node &node = _nodes[ id ];
+	node.state = state;
+	node.move = move;
+	node.visits = 0;
+	node.virtual_losses = virtual_losses;
+	node.is_masked = false;
+	node.parent = parent;
+	node.first_child = -1;
+	node.last_child = -1;
+	node.next_sibling = -1;
+	node.number_children = 0;
+
+	bool blue_moved = state.blue_turn;
+	int winner = play_move( node.state, move );
+
+	node.is_terminal = winner != 0;
+	if( winner == 0 )
+		node.score = 0.0;
+	else
+		node.score = ( winner == -1 ) == blue_moved ? 1.0 : -1.0;
+
+	// the node is complete: other threads can now reach it
+	Node &parent_node = _nodes[ parent ];
+	if( parent_node.first_child == -1 )
+		parent_node.first_child = id;
+	else
+		_nodes[ parent_node.last_child ].next_sibling = id;
+	parent_node.last_child = id;
+	++parent_node.number_children;
+
+	return id;
+}
+
+void MCTS::try_each_possible_move()
+{
+	State state = _nodes[0].state;
+	for( auto &move : legal_moves( state ) )
+		create_node( state, move, 0 );
+}
+
+void MCTS::mask_actions()
+{
+	if( _number_preselected_actions > 0 )
+	{
+		auto possible_moves = preselected_moves( _nodes[0].state, _number_preselected_actions, _rng );
+		if( possible_moves.empty() )
+			return;
+
+		for( int child = _nodes[0].first_child ; child != -1 ; child = _nodes[ child ].next_sibling )
+			_nodes[ child ].is_masked = std::find( possible_moves.begin(),
+			                                       possible_moves.end(),
+			                                       _nodes[ child ].move ) == possible_moves.end();
+	}
+	else
+	{
+		for( int child = _nodes[0].first_child ; child != -1 ; child = _nodes[ child ].next_sibling )
+		{
+			const Move &move = _nodes[ child ].move;
+			_nodes[ child ].is_masked = move.row == 0 || move.row == 5 || move.col == 0 || move.col == 5;
+		}
+	}
+}
+
+double MCTS::uct_value( const Node &node, int parent_visits ) const
+{
+	int virtual_losses = node.virtual_losses;
+	int visits = node.visits + virtual_losses;
+
+	if( visits == 0 )
+		return 999999.9;
+	else
+		return ( ( node.score - virtual_losses ) / visits ) + 0.3 * std::sqrt( std::log( static_cast<double>( parent_visits ) ) / visits );
+}
+
+// Nodes on the selected path get a virtual loss, until backpropagate or remove_virtual_losses
+int MCTS::select_node( Random &rng )
+{
+	int node_id = 0;
+	std::vector<int> potential_nodes;
+	++_nodes[0].virtual_losses;
+
+	while( true )
+	{
+		const Node &node = _nodes[ node_id ];
+		int mask_size = 0;
+
+		if( _number_preselected_actions == 0 && node.state.move_number < _action_masking_time )
+			mask_size = _action_masking_time;
+
+		if( node.number_children < count_empty_positions( node.state ) - mask_size )
+			return node_id;
+
+		double best_value = -10000.0;
+		potential_nodes.clear();
+
+		// other threads' virtual losses only
+		int parent_visits = node.visits + node.virtual_losses - 1;
+
+		for( int child = node.first_child ; child != -1 ; child = _nodes[ child ].next_sibling )
+		{
+			const Node &child_node = _nodes[ child ];
+			if( !child_node.is_masked || ( _number_preselected_actions == 0 && child_node.state.move_number > _action_masking_time ) )
+			{
+				double value = uct_value( child_node, parent_visits );
+				if( value > best_value )
+				{
+					potential_nodes.clear();
+					best_value = value;
+					potential_nodes.push_back( child );
+				}
+				else
+					if( value == best_value )
+						potential_nodes.push_back( child );
+			}
+		}
+
+		if( potential_nodes.empty() )
+			return node_id;
+
+		node_id = rng.pick( potential_nodes );
+		++_nodes[ node_id ].virtual_losses;
+	}
+}
+
+// Must be called with the node's expansion lock, so that threads do not expand the same move twice
+bool MCTS::expand( int node_id, Random &rng, Move &move )
+{
+	std::vector<Move> moves_to_remove;
+	for( int child = _nodes[ node_id ].first_child ; child != -1 ; child = _nodes[ child ].next_sibling )
+		moves_to_remove.push_back( _nodes[ child ].move );
+
+	const State &state = _nodes[ node_id ].state;
+	if( _expansions_with_ghost && greedy_move( state, moves_to_remove, rng, move ) )
+		return true;
+
+	return random_move( state, moves_to_remove, rng, move );
+}
+
+double playout( const State &start,
+                jboolean perspective_is_blue,
+                int first_n_strategy,
+                int playout_depth,
+                double discount_score,
+                Random &rng )
+{
+	State state = start;
+	std::vector<Move> no_moves_to_remove;
+
+	// successive states differ by a few cells: only lines going through them are rescored
+	HeuristicEvaluator evaluator( state.grid, perspective_is_blue, state.blue_pool, state.red_pool );
+	TranspositionTable &table = evaluation_table();
+	TranspositionEntry entry;
+
+	int number_moves = 0;
+	double score = 0.0;
+
+	// like MCTS_GHOST.playout, do not play on from a state that is already won
+	int winner = 0;
+	if( is_victory( state.grid, true, state.blue_pool.size() ) )
+		winner = -1;
+	else
+		if( is_victory( state.grid, false, state.red_pool.size() ) )
+			winner = 1;
+
+	while( winner == 0 && ( number_moves < playout_depth || playout_depth == 0 ) )
+	{
+		Move move;
+		bool has_move = false;
+
+		if( number_moves < first_n_strategy )
+			has_move = greedy_move( state, no_moves_to_remove, rng, move );
+
+		if( !has_move && !random_move( state, no_moves_to_remove, rng, move ) )
+			break;
+
+		winner = play_move( state, move );
+		++number_moves;
+
+		if( winner == 0 )
+		{
+			// evaluator.update diffs against the last evaluated grid, so skipping it on table hits is fine
+			double heuristic_score;
+			std::uint64_t hash = zobrist_perspective( state.hash, state.blue_turn, perspective_is_blue );
+			if( POBO_SYMMETRIC_EVALUATION )
+				heuristic_score = symmetric_heuristic_state( state.grid, perspective_is_blue, state.blue_pool, state.red_pool );
+			else
+				if( table.probe( hash, entry ) )
+					heuristic_score = entry.score;
+				else
+				{
+					evaluator.update( state.grid, state.blue_pool, state.red_pool );
+					heuristic_score = evaluator.score();
+					table.store( hash, heuristic_score, 0, Bound::EXACT );
+				}
+
+			// -1 because we don't want any discount for the first move
+			score += std::pow( discount_score, number_moves - 1 ) * heuristic_score;
+		}
+	}
+
+	// Like in MCTS_GHOST.playout, victories are scored from Red's point of view
+	if( winner == -1 )
+		score += -std::pow( discount_score, number_moves - 1 );
+	else
+		if( winner == 1 )
+			score += std::pow( discount_score, number_moves - 1 );
+
+	if( number_moves == 0 )
+		return static_cast<double>( winner );
+
+	return score / number_moves;
+}
+
+double MCTS::playout( int node_id, Random &rng )
+{
+	const State &state = _nodes[ node_id ].state;
+	return ::playout( state, state.blue_turn, _first_n_strategy, _playout_depth, _discount_score, rng );
+}
+
+void MCTS::backpropagate( int node_id, double score )
+{
+	while( true )
+	{
+		Node &node = _nodes[ node_id ];
+		atomic_add( node.score, -score );
+		++node.visits;
+		--node.virtual_losses;
+
+		if( node_id == 0 ) // root
+			return;
+
+		node_id = node.parent;
+		score = -score;
+	}
+}
+
+void MCTS::remove_virtual_losses( int node_id )
+{
+	while( true )
+	{
+		--_nodes[ node_id ].virtual_losses;
+
+		if( node_id == 0 ) // root
+			return;
+
+		node_id = _nodes[ node_id ].parent;
+	}
+}
+
+void MCTS::search( std::chrono::steady_clock::time_point start,
+                   std::chrono::milliseconds timeout,
+                   Random &rng )
+{
+	while( std::chrono::steady_clock::now() - start < timeout )
+	{
+		int selected = select_node( rng );
+		Node &selected_node = _nodes[ selected ];
+
+		// if the selected node is terminal, backpropagate its score and move on
+		if( selected_node.is_terminal )
+		{
+			++selected_node.visits;
+			--selected_node.virtual_losses;
+			backpropagate( selected_node.parent, selected_node.score );
+			continue;
+		}
+
+		int expanded = -1;
+		int number_children = 0;
+		{
+			std::lock_guard<std::mutex> lock( selected_node.expansion_lock );
+			Move move;
+			if( expand( selected, rng, move ) )
+				expanded = create_node( selected_node.state, move, selected, 1 );
+			number_children = selected_node.number_children;
+		}
+
+		if( expanded == -1 )
+		{
+			remove_virtual_losses( selected );
+			continue;
+		}
+
+		// other threads may already have searched below the expanded node:
+		// only this playout's value is backpropagated, not the node's whole score
+		Node &expanded_node = _nodes[ expanded ];
+		double value = expanded_node.score; // terminal nodes keep their score
+		if( !expanded_node.is_terminal )
+		{
+			// first expansions are the most optimal one according to the heuristics
+			value = -playout( expanded, rng ) / number_children;
+			atomic_add( expanded_node.score, value );
+		}
+		--expanded_node.virtual_losses;
+
+		backpropagate( selected, value );
+	}
+}
+
+Move MCTS::select_move( const State &state,
+                        jboolean ai_is_blue,
+                        int ai_level,
+                        long timeout_in_ms )
+{
+	auto start = std::chrono::steady_clock::now();
+	auto timeout = std::chrono::milliseconds( timeout_in_ms );
+
+	// Reset tree
+	_nodes.clear();
+
+	Node &root = _nodes[ _nodes.allocate() ];
+	root.state = state;
+	root.score = 0.0;
+	root.visits = 1;
+	root.virtual_losses = 0;
+	root.is_terminal = false;
+	root.is_masked = false;
+	root.parent = 0;
+	root.first_child = -1;
+	root.last_child = -1;
+	root.next_sibling = -1;
+	root.number_children = 0;
+
+	// generate our moves
+	try_each_possible_move();
+	mask_actions();
+
+	// the calling thread searches too, with the member rng, so that a single-threaded search runs like before.
+	// Workers, kept from one call to the next, have their own generator.
+	_workers.run( _number_threads, _rng, [this, start, timeout]( Random &rng ) { search( start, timeout, rng ); } );
+
+	std::map< double, std::vector<int>, std::greater<double> > children_by_ratio;
+	for( int child = _nodes[0].first_child ; child != -1 ; child = _nodes[ child ].next_sibling )
+	{
+		Node &node = _nodes[ child ];
+		jint pool_size = ( ai_is_blue ? node.state.blue_pool : node.state.red_pool ).size();
+		if( is_victory( node.state.grid, ai_is_blue, pool_size ) )
+			return node.move;
+
+		if( node.visits == 0 )
+			continue;
+
+		children_by_ratio[ node.score / node.visits ].push_back( child );
+	}
+
+	// no children have been visited within the time budget
+	if( children_by_ratio.empty() )
+	{
+		std::vector<int> children;
+		for( int child = _nodes[0].first_child ; child != -1 ; child = _nodes[ child ].next_sibling )
+			children.push_back( child );
+
+		return _nodes[ _rng.pick( children ) ].move;
+	}
+
+	int number_ratios = static_cast<int>( children_by_ratio.size() );
+	int level = number_ratios <= ai_level ? number_ratios - 1 : std::max( 0, ai_level );
+	auto best_children = std::next( children_by_ratio.begin(), level );
+
+	return _nodes[ _rng.pick( best_children->second ) ].move;
+}
@@ -0,0 +1,133 @@
+#ifndef POBO_MCTS_HPP
+#define POBO_MCTS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "game.hpp"
+#include "random.hpp"
+#include "worker_pool.hpp"
+
+// Nodes are shared by all search threads. Statistics are atomic, and children are linked through node indexes:
+// a child is appended under its parent's lock, and fully written before being linked.
+// virtual_losses counts the threads currently searching below the node: each one counts as a lost visit
+// in uct_value, so that other threads favour other nodes.
+struct Node
+{
+	State state; // state after playing the node's move, with the next player to move
+	Move move;
+	std::atomic<double> score;
+	std::atomic<int> visits;
+	std::atomic<int> virtual_losses;
+	bool is_terminal;
+	bool is_masked;
+	int parent;
+	std::atomic<int> first_child;
+	int last_child; // only read and written under the node's lock
+	std::atomic<int> next_sibling;
+	std::atomic<int> number_children;
+	std::mutex expansion_lock;
+};
+
+// Node storage in fixed-size chunks, allocated as needed: nodes never move once created,
+// so threads can read them while others add new ones.
+class NodePool
+{
+	static constexpr int CHUNK_BITS = 10;
+	static constexpr int CHUNK_SIZE = 1 << CHUNK_BITS;
+	static constexpr int MAX_CHUNKS = 1024;
+
+	std::unique_ptr<Node[]> _chunks[ MAX_CHUNKS ];
+	std::atomic<int> _size;
+	std::mutex _allocation_lock;
+
+public:
+	NodePool();
+
+	// Return the index of a new node, or -1 if the pool is full
+	int allocate();
+	void clear();
+	int size() const { return _size.load(); }
+
+	Node &operator[]( int id ) { return _chunks[ id >> CHUNK_BITS ][ id & ( CHUNK_SIZE - 1 ) ]; }
+	const Node &operator[]( int id ) const { return _chunks[ id >> CHUNK_BITS ][ id & ( CHUNK_SIZE - 1 ) ]; }
+};
+
+// Same as MCTS_GHOST.playout: play from start greedy moves for the first first_n_strategy moves,
+// then random ones, until a victory or playout_depth moves (no limit if 0). Return the mean of the
+// discounted heuristic scores of the reached states, for the perspective player, plus -1 for a Blue
+// victory or 1 for a Red victory (also discounted). If start is already won, no moves are played
+// and that victory is returned (-1 or 1). Return 0 if no moves could be played otherwise.
+double playout( const State &start,
+                jboolean perspective_is_blue,
+                int first_n_strategy,
+                int playout_depth,
+                double discount_score,
+                Random &rng );
+
+// Native port of the tree search in MCTS_GHOST.kt, with the same selection, expansion and playout policies.
+// With several threads, all of them grow the same tree (tree parallelisation with virtual loss).
+class MCTS
+{
+	NodePool _nodes;
+	Random _rng;
+	WorkerPool &_workers;
+
+	int _number_preselected_actions;
+	bool _expansions_with_ghost;
+	int _first_n_strategy;
+	int _playout_depth;
+	int _action_masking_time;
+	double _discount_score;
+	int _number_threads;
+
+	// virtual_losses is 1 for a node being played out, so that other threads do not all select it meanwhile
+	int create_node( const State &state, const Move &move, int parent, int virtual_losses = 0 );
+	void try_each_possible_move();
+	void mask_actions();
+
+	int select_node( Random &rng );
+	double uct_value( const Node &node, int parent_visits ) const;
+	bool expand( int node_id, Random &rng, Move &move );
+	double playout( int node_id, Random &rng );
+	void backpropagate( int node_id, double score );
+	void remove_virtual_losses( int node_id );
+
+	// Search loop of each thread
+	void search( std::chrono::steady_clock::time_point start,
+	             std::chrono::milliseconds timeout,
+	             Random &rng );
+
+public:
+	// Search threads are the workers of the given pool, which must outlive the MCTS
+	MCTS( WorkerPool &workers,
+	      int number_preselected_actions,
+	      bool expansions_with_ghost,
+	      int first_n_strategy,
+	      int playout_depth,
+	      int action_masking_time,
+	      double discount_score,
+	      int number_threads = 1 );
+
+	// Run the search from state until timeout_in_ms is reached, and return the move picked for the given AI level
+	Move select_move( const State &state,
+	                  jboolean ai_is_blue,
+	                  int ai_level,
+	                  long timeout_in_ms );
+
+	bool has_parameters( int number_preselected_actions,
+	                     bool expansions_with_ghost,
+	                     int first_n_strategy,
+	                     int playout_depth,
+	                     int action_masking_time,
+	                     double discount_score,
+	                     int number_threads ) const;
+
+	// Number of nodes of the last search
+	int number_nodes() const { return _nodes.size(); }
+};
+
+#endif //POBO_MCTS_HPP
@@ -10,10 +10,8 @@
 #include "pobo_objective.hpp"
 
 Builder::Builder( jbyte *const grid,
-                  jbyte *const blue_pool,
-                  jint blue_pool_size,
-                  jbyte *const red_pool,
-                  jint red_pool_size,
+                  const Pool &blue_pool,
+                  const Pool &red_pool,
                   jboolean blue_turn,
                   jbyte *const to_remove_row,
                   jbyte *const to_remove_col,
@@ -22,26 +20,13 @@ Builder::Builder( jbyte *const grid,
 				: ModelBuilder(),
 				  _grid( grid ),
 				  _blue_pool( blue_pool ),
-				  _blue_pool_size( blue_pool_size ),
 				  _red_pool( red_pool ),
-				  _red_pool_size( red_pool_size ),
 				  _blue_turn( blue_turn ),
 				  _to_remove_row( to_remove_row ),
 				  _to_remove_col( to_remove_col ),
 				  _to_remove_p( to_remove_p ),
 				  _number_to_remove( number_to_remove )
 {
-	if( _blue_turn )
-	{
-		_pool = _blue_pool;
-		_pool_size = _blue_pool_size;
-	}
-	else
-	{
-		_pool = _red_pool;
-		_pool_size = _red_pool_size;
-	}
-
 	piece.push_back( 0 ); // Piece variable is at index 0 of the Variable vector
 	coordinates.push_back( 1 );
 	coordinates.push_back( 2 ); // Coordinates (row,column) at respectively at indexes 1 and 2
@@ -56,7 +41,7 @@ void Builder::declare_variables()
 
 void Builder::declare_constraints()
 {
-	constraints.emplace_back( std::make_shared<HasPiece>( piece, _pool, _pool_size ) );
+	constraints.emplace_back( std::make_shared<HasPiece>( piece, _blue_turn ? _blue_pool : _red_pool ) );
 	constraints.emplace_back( std::make_shared<FreePosition>( coordinates, _grid ) );
 
 	if( _number_to_remove > 0 )
@@ -69,7 +54,5 @@ void Builder::declare_objective()
 																							 _grid,
 																							 _blue_turn,
 																							 _blue_pool,
-																							 _blue_pool_size,
-																							 _red_pool,
-																							 _red_pool_size );
+																							 _red_pool );
 }
@@ -5,20 +5,17 @@
 #ifndef POBO_BUILDER_HPP
 #define POBO_BUILDER_HPP
 
-#include <jni.h>
+#include "../jni_types.hpp"
 
 #include <vector>
 #include "../lib/include/ghost/model_builder.hpp"
+#include "../pool.hpp"
 
 class Builder : public ghost::ModelBuilder
 {
 	jbyte *_grid;
-	jbyte *_pool;
-	jint _pool_size;
-	jbyte *_blue_pool;
-	jint _blue_pool_size;
-	jbyte *_red_pool;
-	jint _red_pool_size;
+	Pool _blue_pool;
+	Pool _red_pool;
 	jboolean _blue_turn;
 	jbyte *_to_remove_row;
 	jbyte *_to_remove_col;
@@ -30,10 +27,8 @@ class Builder : public ghost::ModelBuilder
 
 public:
 	Builder( jbyte *const grid,
-	         jbyte *const blue_pool,
-	         jint blue_pool_size,
-	         jbyte *const red_pool,
-	         jint red_pool_size,
+	         const Pool &blue_pool,
+	         const Pool &red_pool,
 	         jboolean blue_turn,
 	         jbyte *const to_remove_row = nullptr,
 	         jbyte *const to_remove_col = nullptr,
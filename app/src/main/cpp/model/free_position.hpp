@@ -5,7 +5,7 @@
 #ifndef POBO_FREE_POSITION_HPP
 #define POBO_FREE_POSITION_HPP
 
-#include <jni.h>
+#include "../jni_types.hpp"
 
 #include <vector>
 #include "../lib/include/ghost/constraint.hpp"
@@ -6,24 +6,13 @@
 
 #include "has_piece.hpp"
 
-HasPiece::HasPiece( const std::vector<int>& variables_index, jbyte * const pool, jint pool_size )
+HasPiece::HasPiece( const std::vector<int>& variables_index, const Pool &pool )
         : Constraint( variables_index ),
-          _pool( pool ),
-          _pool_size( pool_size )
+          _pool( pool )
 { }
 
 double HasPiece::required_error( const std::vector<ghost::Variable *> &variables ) const
 {
-    int piece = variables[0]->get_value();
-    bool piece_found = false;
-
-    for( int i = 0 ; i < _pool_size ; ++i )
-        if( piece == static_cast<int>( _pool[i] ) )
-        {
-            piece_found = true;
-            break;
-        }
-
-    _cache_error = piece_found ? 0. : 1.;
+    _cache_error = _pool.has( variables[0]->get_value() ) ? 0. : 1.;
     return _cache_error;
 }
@@ -5,18 +5,18 @@
 #ifndef POBO_HAS_PIECE_HPP
 #define POBO_HAS_PIECE_HPP
 
-#include <jni.h>
+#include "../jni_types.hpp"
 
 #include <vector>
 #include "../lib/include/ghost/constraint.hpp"
+#include "../pool.hpp"
 
 class HasPiece : public ghost::Constraint {
-	jbyte *_pool;
-	jint _pool_size;
+	Pool _pool;
 	mutable double _cache_error;
 
 public:
-	HasPiece(const std::vector<int> &variables_index, jbyte *const pool, jint pool_size);
+	HasPiece(const std::vector<int> &variables_index, const Pool &pool);
 
 	double required_error(const std::vector<ghost::Variable*> &variables) const override;
 
@@ -5,34 +5,27 @@
 #ifndef POBO_OBJECTIVE_HPP
 #define POBO_OBJECTIVE_HPP
 
-#include <jni.h>
+#include "../jni_types.hpp"
 
 #include <vector>
 #include "../lib/include/ghost/objective.hpp"
+#include "../pool.hpp"
 
 class PoboObjective : public ghost::Maximize
 {
 	jbyte *_grid;
 	jboolean _blue_turn;
-	jbyte *_blue_pool;
-	jint _blue_pool_size;
-	jbyte *_red_pool;
-	jint _red_pool_size;
+	Pool _blue_pool;
+	Pool _red_pool;
 
 	mutable jbyte _simulation_grid[36];
-	mutable jbyte _simulation_blue_pool[8];
-	mutable jint  _simulation_blue_pool_size;
-	mutable jbyte _simulation_red_pool[8];
-	mutable jint  _simulation_red_pool_size;
 
 public:
 	PoboObjective( const std::vector <ghost::Variable> &variables,
 								 jbyte *const grid,
 	               jboolean blue_turn,
-	               jbyte *const blue_pool,
-								 jint blue_pool_size,
-								 jbyte *const red_pool,
-								 jint red_pool_size );
+	               const Pool &blue_pool,
+	               const Pool &red_pool );
 
 	double required_cost( const std::vector<ghost::Variable *> &variables ) const override;
 };
@@ -5,7 +5,7 @@
 #ifndef POBO_REMOVED_POSITIONS_HPP
 #define POBO_REMOVED_POSITIONS_HPP
 
-#include <jni.h>
+#include "../jni_types.hpp"
 
 #include <vector>
 #include "../lib/include/ghost/constraint.hpp"
@@ -0,0 +1,336 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+#include "move_generator.hpp"
+#include "simulator.hpp"
+#include "heuristics.hpp"
+#include "symmetry.hpp"
+#include "transposition_table.hpp"
+
+#ifndef POBO_WITHOUT_GHOST
+#include "lib/include/ghost/solver.hpp"
+#include "model/builder.hpp"
+#endif
+
+double score_move( const State &state, const Move &move )
+{
+	jbyte simulation_grid[36];
+	std::copy( state.grid, state.grid + 36, simulation_grid );
+
+	Pool simulation_blue_pool = state.blue_pool;
+	Pool simulation_red_pool = state.red_pool;
+
+	simulate_move( move.piece,
+	               move.row,
+	               move.col,
+	               simulation_grid,
+	               state.blue_turn,
+	               simulation_blue_pool,
+	               simulation_red_pool );
+
+	return heuristic_state( simulation_grid,
+	                        state.blue_turn,
+	                        simulation_blue_pool,
+	                        simulation_red_pool );
+}
+
+// score_move, where the state has already been evaluated: only the lines the move modified are rescanned,
+// unless the reached position is already in the evaluation table
+static double score_move( const State &state, [[maybe_unused]] const HeuristicEvaluator &state_evaluator, const Move &move )
+{
+	jbyte simulation_grid[36];
+	std::copy( state.grid, state.grid + 36, simulation_grid );
+
+	Pool simulation_blue_pool = state.blue_pool;
+	Pool simulation_red_pool = state.red_pool;
+
+	// the player to move does not change: the hash is the one of the reached position scored for the mover
+	std::uint64_t hash = state.hash;
+
+	simulate_move( move.piece,
+	               move.row,
+	               move.col,
+	               simulation_grid,
+	               state.blue_turn,
+	               simulation_blue_pool,
+	               simulation_red_pool,
+	               &hash );
+
+#if POBO_SYMMETRIC_EVALUATION
+	return symmetric_heuristic_state( simulation_grid, state.blue_turn, simulation_blue_pool, simulation_red_pool );
+#else
+	TranspositionTable &table = evaluation_table();
+	TranspositionEntry entry;
+	if( table.probe( hash, entry ) )
+		return entry.score;
+
+	HeuristicEvaluator evaluator = state_evaluator;
+	evaluator.update( simulation_grid, simulation_blue_pool, simulation_red_pool );
+	double score = evaluator.score();
+
+	table.store( hash, score, 0, Bound::EXACT );
+	return score;
+#endif
+}
+
+// On symmetric grids (typically in the first moves), moves mapped to one another by a symmetry of the grid
+// lead to symmetric positions: with POBO_SYMMETRIC_EVALUATION, they have the same score and only one move per class
+// needs to be scored. The representative of a move is the smallest move slot of its class.
+// Otherwise, each move is its own representative: heuristic_state is not exactly symmetric (see symmetry.hpp).
+static void representative_slots( [[maybe_unused]] const State &state, int ( &representatives )[ NUMBER_MOVE_SLOTS ] )
+{
+	for( int slot = 0 ; slot < NUMBER_MOVE_SLOTS ; ++slot )
+		representatives[ slot ] = slot;
+
+#if POBO_SYMMETRIC_EVALUATION
+	int symmetries[ NUMBER_SYMMETRIES ];
+	int number_symmetries = stabiliser_symmetries( state.grid, symmetries );
+
+	for( int slot = 0 ; slot < NUMBER_MOVE_SLOTS ; ++slot )
+		for( int i = 0 ; i < number_symmetries ; ++i )
+		{
+			int symmetric_slot = ( slot / 36 ) * 36 + symmetry_table.cell[ symmetries[i] ][ slot % 36 ];
+			representatives[ slot ] = std::min( representatives[ slot ], symmetric_slot );
+		}
+#endif
+}
+
+int score_moves( const State &state, double * const scores )
+{
+	const Pool &pool = state.blue_turn ? state.blue_pool : state.red_pool;
+	HeuristicEvaluator state_evaluator( state.grid, state.blue_turn, state.blue_pool, state.red_pool );
+	int representatives[ NUMBER_MOVE_SLOTS ];
+	representative_slots( state, representatives );
+	int number_moves = 0;
+
+	for( int piece = 1 ; piece <= 2 ; ++piece )
+		for( int index = 0 ; index < 36 ; ++index )
+		{
+			int slot = move_slot( piece, index / 6, index % 6 );
+			double &score = scores[ slot ];
+			if( !pool.has( piece ) || state.grid[ index ] != 0 )
+				score = std::numeric_limits<double>::quiet_NaN();
+			else
+			{
+				// representatives come first and are legal too, since the grid is invariant
+				if( representatives[ slot ] != slot )
+					score = scores[ representatives[ slot ] ];
+				else
+					score = score_move( state, state_evaluator, Move( piece, index / 6, index % 6 ) );
+				++number_moves;
+			}
+		}
+
+	return number_moves;
+}
+
+bool native_visit_moves( const State &state,
+                         const std::vector<Move> &moves_to_remove,
+                         const MoveVisitor &visitor )
+{
+	HeuristicEvaluator state_evaluator( state.grid, state.blue_turn, state.blue_pool, state.red_pool );
+	int representatives[ NUMBER_MOVE_SLOTS ];
+	representative_slots( state, representatives );
+
+	// scores by representative: a representative may be in moves_to_remove while other moves of its class are not
+	double class_scores[ NUMBER_MOVE_SLOTS ];
+	std::fill( class_scores, class_scores + NUMBER_MOVE_SLOTS, std::numeric_limits<double>::quiet_NaN() );
+
+	bool found = false;
+	// legal_moves already follows the solver order: Po then Bo, positions in row-major order
+	for( auto &move : legal_moves( state ) )
+	{
+		if( std::find( moves_to_remove.begin(), moves_to_remove.end(), move ) != moves_to_remove.end() )
+			continue;
+
+		double &score = class_scores[ representatives[ move_slot( move.piece, move.row, move.col ) ] ];
+		if( std::isnan( score ) )
+			score = score_move( state, state_evaluator, move );
+
+		found = true;
+		if( !visitor( move, score ) )
+			break;
+	}
+
+	return found;
+}
+
+bool native_best_moves( const State &state,
+                        const std::vector<Move> &moves_to_remove,
+                        int number_best,
+                        std::vector<double> &costs,
+                        std::vector<Move> &moves )
+{
+	costs.clear();
+	moves.clear();
+	if( number_best <= 0 )
+		return false;
+
+	// once number_best moves are kept, a move must reach threshold, the number_best-th highest cost so far
+	double threshold = std::numeric_limits<double>::lowest();
+	std::vector<double> sorted_costs;
+
+	native_visit_moves( state, moves_to_remove, [&]( const Move &move, double cost )
+	{
+		if( static_cast<int>( moves.size() ) >= number_best && cost < threshold )
+			return true;
+
+		costs.push_back( cost );
+		moves.push_back( move );
+
+		if( static_cast<int>( moves.size() ) >= number_best )
+		{
+			sorted_costs = costs;
+			std::nth_element( sorted_costs.begin(), sorted_costs.begin() + ( number_best - 1 ), sorted_costs.end(), std::greater<double>() );
+			threshold = sorted_costs[ number_best - 1 ];
+
+			int kept = 0;
+			for( int i = 0 ; i < static_cast<int>( moves.size() ) ; ++i )
+				if( costs[i] >= threshold )
+				{
+					costs[kept] = costs[i];
+					moves[kept] = moves[i];
+					++kept;
+				}
+
+			costs.resize( kept );
+			moves.resize( kept );
+		}
+
+		return true;
+	} );
+
+	return !moves.empty();
+}
+
+bool native_complete_search( const State &state,
+                             const std::vector<Move> &moves_to_remove,
+                             std::vector<double> &costs,
+                             std::vector< std::vector<int> > &solutions )
+{
+	return native_visit_moves( state,
+	                           moves_to_remove,
+	                           [&]( const Move &move, double cost )
+	                           {
+		                           costs.push_back( cost );
+		                           solutions.push_back( { move.piece, move.row, move.col } );
+		                           return true;
+	                           } );
+}
+
+#ifndef POBO_WITHOUT_GHOST
+// Run f on a ghost::Solver for a Builder model of the state, without the moves in moves_to_remove
+template<typename Function>
+static bool with_ghost_solver( const State &state, const std::vector<Move> &moves_to_remove, Function f )
+{
+	jbyte grid[36];
+	std::copy( state.grid, state.grid + 36, grid );
+
+	int number_to_remove = static_cast<int>( moves_to_remove.size() );
+	std::vector<jbyte> to_remove_row( number_to_remove );
+	std::vector<jbyte> to_remove_col( number_to_remove );
+	std::vector<jbyte> to_remove_p( number_to_remove );
+
+	for( int i = 0 ; i < number_to_remove ; ++i )
+	{
+		to_remove_row[i] = moves_to_remove[i].row;
+		to_remove_col[i] = moves_to_remove[i].col;
+		to_remove_p[i] = moves_to_remove[i].piece;
+	}
+
+	Builder builder( grid,
+	                 state.blue_pool,
+	                 state.red_pool,
+	                 state.blue_turn,
+	                 to_remove_row.data(),
+	                 to_remove_col.data(),
+	                 to_remove_p.data(),
+	                 number_to_remove );
+
+	ghost::Solver solver( builder );
+	return f( solver );
+}
+
+bool ghost_visit_moves( const State &state,
+                        const std::vector<Move> &moves_to_remove,
+                        const MoveVisitor &visitor )
+{
+	return with_ghost_solver( state, moves_to_remove, [&]( auto &solver )
+	{
+		return solver.complete_search( [&]( const std::vector<int> &solution, double cost )
+		                               {
+			                               return visitor( Move( solution[0], solution[1], solution[2] ), cost );
+		                               } );
+	} );
+}
+
+bool ghost_best_moves( const State &state,
+                       const std::vector<Move> &moves_to_remove,
+                       int number_best,
+                       std::vector<double> &costs,
+                       std::vector<Move> &moves )
+{
+	std::vector< std::vector<int> > solutions;
+	moves.clear();
+
+	bool success = with_ghost_solver( state, moves_to_remove, [&]( auto &solver )
+	{
+		ghost::Options options;
+		return solver.complete_optimization( number_best, costs, solutions, options );
+	} );
+
+	for( auto &solution : solutions )
+		moves.emplace_back( solution[0], solution[1], solution[2] );
+
+	return success;
+}
+
+bool ghost_complete_search( const State &state,
+                            const std::vector<Move> &moves_to_remove,
+                            std::vector<double> &costs,
+                            std::vector< std::vector<int> > &solutions )
+{
+	return with_ghost_solver( state, moves_to_remove, [&]( auto &solver )
+	{
+		return solver.complete_search( costs, solutions );
+	} );
+}
+#endif
+
+bool visit_moves( const State &state,
+                  const std::vector<Move> &moves_to_remove,
+                  const MoveVisitor &visitor )
+{
+#if POBO_GHOST_MOVE_GENERATOR
+	return ghost_visit_moves( state, moves_to_remove, visitor );
+#else
+	return native_visit_moves( state, moves_to_remove, visitor );
+#endif
+}
+
+bool best_moves( const State &state,
+                 const std::vector<Move> &moves_to_remove,
+                 int number_best,
+                 std::vector<double> &costs,
+                 std::vector<Move> &moves )
+{
+#if POBO_GHOST_MOVE_GENERATOR
+	return ghost_best_moves( state, moves_to_remove, number_best, costs, moves );
+#else
+	return native_best_moves( state, moves_to_remove, number_best, costs, moves );
+#endif
+}
+
+bool complete_search( const State &state,
+                      const std::vector<Move> &moves_to_remove,
+                      std::vector<double> &costs,
+                      std::vector< std::vector<int> > &solutions )
+{
+#if POBO_GHOST_MOVE_GENERATOR
+	return ghost_complete_search( state, moves_to_remove, costs, solutions );
+#else
+	return native_complete_search( state, moves_to_remove, costs, solutions );
+#endif
+}
@@ -0,0 +1,100 @@
+#ifndef POBO_MOVE_GENERATOR_HPP
+#define POBO_MOVE_GENERATOR_HPP
+
+#include <functional>
+#include <vector>
+#include "game.hpp"
+
+// Define POBO_GHOST_MOVE_GENERATOR to enumerate moves with ghost::Solver::complete_search
+// instead of the native generator, for comparison purpose.
+#ifndef POBO_GHOST_MOVE_GENERATOR
+#define POBO_GHOST_MOVE_GENERATOR 0
+#endif
+
+// Host builds without a GHOST library (POBO_WITHOUT_GHOST) only have the native generator
+#if POBO_GHOST_MOVE_GENERATOR && defined( POBO_WITHOUT_GHOST )
+#error "POBO_GHOST_MOVE_GENERATOR needs the GHOST library"
+#endif
+
+// Heuristic score of the state reached by playing the move, from the point of view of the player
+// making it. Same value as PoboObjective::required_cost.
+double score_move( const State &state, const Move &move );
+
+// Batch scores are stored by move slot: Po moves first, then Bo moves, positions in row-major order
+constexpr int NUMBER_MOVE_SLOTS = 72;
+
+inline int move_slot( int piece, int row, int col )
+{
+	return ( piece - 1 ) * 36 + row * 6 + col;
+}
+
+// score_move of every legal move of the player to move, written at its move_slot in scores,
+// which must hold NUMBER_MOVE_SLOTS values. Illegal moves get NaN. Return the number of legal moves.
+// With POBO_SYMMETRIC_EVALUATION, moves symmetric to one another on a symmetric grid are scored once (see stabiliser_symmetries).
+int score_moves( const State &state, double * const scores );
+
+// Called with each move found by a move generator and its cost. Return false to stop the enumeration.
+using MoveVisitor = std::function<bool( const Move &move, double cost )>;
+
+// Legal moves of the player to move, except the ones in moves_to_remove, given one by one to visitor
+// with their score_move as cost, in the native_complete_search order. Return false if there are no legal moves.
+bool native_visit_moves( const State &state,
+                         const std::vector<Move> &moves_to_remove,
+                         const MoveVisitor &visitor );
+
+// The number_best moves with the highest costs among the ones native_visit_moves gives, plus the moves tied
+// with the last of them, in the same order. Return false if there are no legal moves.
+bool native_best_moves( const State &state,
+                        const std::vector<Move> &moves_to_remove,
+                        int number_best,
+                        std::vector<double> &costs,
+                        std::vector<Move> &moves );
+
+// Legal moves of the player to move, except the ones in moves_to_remove, as {piece, row, col} solutions
+// with their score_move as cost. Same output as ghost::Solver::complete_search on a Builder model:
+// solutions are ordered by piece, row then column. Return false if there are no legal moves.
+// Like score_moves, symmetric moves share the score of the first one with POBO_SYMMETRIC_EVALUATION.
+bool native_complete_search( const State &state,
+                             const std::vector<Move> &moves_to_remove,
+                             std::vector<double> &costs,
+                             std::vector< std::vector<int> > &solutions );
+
+#ifndef POBO_WITHOUT_GHOST
+// Same as native_visit_moves, streamed from ghost::Solver::complete_search on a Builder model
+bool ghost_visit_moves( const State &state,
+                        const std::vector<Move> &moves_to_remove,
+                        const MoveVisitor &visitor );
+
+// Same as native_best_moves, through ghost::Solver::complete_optimization on a Builder model
+bool ghost_best_moves( const State &state,
+                       const std::vector<Move> &moves_to_remove,
+                       int number_best,
+                       std::vector<double> &costs,
+                       std::vector<Move> &moves );
+
+// Same as native_complete_search, through a Builder model and ghost::Solver::complete_search
+bool ghost_complete_search( const State &state,
+                            const std::vector<Move> &moves_to_remove,
+                            std::vector<double> &costs,
+                            std::vector< std::vector<int> > &solutions );
+#endif
+
+// Call the move generator selected by POBO_GHOST_MOVE_GENERATOR, without storing moves
+bool visit_moves( const State &state,
+                  const std::vector<Move> &moves_to_remove,
+                  const MoveVisitor &visitor );
+
+// Call the move generator selected by POBO_GHOST_MOVE_GENERATOR, keeping the best moves only
+bool best_moves( const State &state,
+                 const std::vector<Move> &moves_to_remove,
+                 int number_best,
+                 std::vector<double> &costs,
+                 std::vector<Move> &moves );
+
+// Call the move generator selected by POBO_GHOST_MOVE_GENERATOR
+bool complete_search( const State &state,
+                      const std::vector<Move> &moves_to_remove,
+                      std::vector<double> &costs,
+                      std::vector< std::vector<int> > &solutions );
+
+#endif //POBO_MOVE_GENERATOR_HPP
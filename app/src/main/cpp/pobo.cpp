@@ -1,25 +1,43 @@
 #include <jni.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <limits>
 #include <vector>
 
-#include "lib/include/ghost/solver.hpp"
-#include "model/builder.hpp"
-#include "lib/include/ghost/thirdparty/randutils.hpp"
 #include "heuristics.hpp"
-
-// From https://manski.net/2012/05/logging-from-c-on-android/
-#include <android/log.h>
-//*
-#define ALOG(...)
-/*/
-#define ALOG( ... ) __android_log_print(ANDROID_LOG_INFO, "pobotag C++", __VA_ARGS__)
-//*/
+#include "pool.hpp"
+#include "random.hpp"
+#include "mcts.hpp"
+#include "alpha_beta.hpp"
+#include "move_generator.hpp"
+#include "session.hpp"
+#include "trace.hpp"
 
 using namespace std::literals::chrono_literals;
 
 // From https://www.baeldung.com/jni
 // See also https://developer.android.com/training/articles/perf-jni
 
+// Pools are sent as arrays of pieces, the native engine only keeps their number of Po and Bo.
+// A player has 8 pieces: larger sizes are clamped, so that the copy cannot overflow pool.
+static Pool get_pool( JNIEnv *env, jbyteArray k_pool, jint k_pool_size )
+{
+	jbyte pool[8];
+	jint pool_size = std::clamp( k_pool_size, 0, 8 );
+	env->GetByteArrayRegion( k_pool, 0, pool_size, pool );
+	return make_pool( pool, pool_size );
+}
+
+// Cells index the Zobrist keys by their value + 2 (see zobrist_cell): states must only be built
+// from grids with values from -2 (Blue Bo) to 2 (Red Bo). Callers answer as if no moves could be played otherwise.
+static bool is_valid_grid( const jbyte * const grid )
+{
+	return std::all_of( grid, grid + 36, []( jbyte cell ) { return cell >= -2 && cell <= 2; } );
+}
+
 JNIEXPORT jintArray JNICALL
 ghost_solver_call( JNIEnv *env,
                    jobject thiz,
@@ -34,85 +52,77 @@ ghost_solver_call( JNIEnv *env,
                    jbyteArray k_to_remove_p,
                    jint k_number_to_remove )
 {
-	randutils::mt19937_rng rng;
-
 	// Inputs //
 	jbyte cpp_grid[36];
-	jbyte blue_pool[k_blue_pool_size];
-  jbyte red_pool[k_red_pool_size];
-
 	env->GetByteArrayRegion( k_grid, 0, 36, cpp_grid );
-	env->GetByteArrayRegion( k_blue_pool, 0, k_blue_pool_size, blue_pool );
-	env->GetByteArrayRegion( k_red_pool, 0, k_red_pool_size, red_pool );
 
-	jbyte to_remove_row[k_number_to_remove];
-	env->GetByteArrayRegion( k_to_remove_row, 0, k_number_to_remove, to_remove_row );
+	// Output: Move (Piece + Position) + Cost
+	jint solution[4] = { 42, 0, 0, 0 };
+	jintArray sol = env->NewIntArray( 4 );
+
+	if( !is_valid_grid( cpp_grid ) )
+	{
+		env->SetIntArrayRegion( sol, 0, 4, solution );
+		return sol;
+	}
+
+	Pool blue_pool = get_pool( env, k_blue_pool, k_blue_pool_size );
+	Pool red_pool = get_pool( env, k_red_pool, k_red_pool_size );
+
+	// there are at most NUMBER_MOVE_SLOTS moves to remove
+	jint number_to_remove = std::clamp( k_number_to_remove, 0, NUMBER_MOVE_SLOTS );
+
+	jbyte to_remove_row[NUMBER_MOVE_SLOTS];
+	env->GetByteArrayRegion( k_to_remove_row, 0, number_to_remove, to_remove_row );
+
+	jbyte to_remove_col[NUMBER_MOVE_SLOTS];
+	env->GetByteArrayRegion( k_to_remove_col, 0, number_to_remove, to_remove_col );
 
-	jbyte to_remove_col[k_number_to_remove];
-	env->GetByteArrayRegion( k_to_remove_col, 0, k_number_to_remove, to_remove_col );
+	jbyte to_remove_p[NUMBER_MOVE_SLOTS];
+	env->GetByteArrayRegion( k_to_remove_p, 0, number_to_remove, to_remove_p );
 
-	jbyte to_remove_p[k_number_to_remove];
-	env->GetByteArrayRegion( k_to_remove_p, 0, k_number_to_remove, to_remove_p );
+	// buffers reused by the following calls of this thread
+	thread_local std::vector<Move> moves_to_remove;
+	thread_local std::vector<double> costs;
+	thread_local std::vector<Move> moves;
+
+	moves_to_remove.clear();
+	for( int i = 0 ; i < number_to_remove ; ++i )
+		moves_to_remove.emplace_back( to_remove_p[i], to_remove_row[i], to_remove_col[i] );
 
 	// Move search //
-	Builder builder( cpp_grid,
-                     blue_pool,
-                     k_blue_pool_size,
-                     red_pool,
-                     k_red_pool_size,
-                     k_blue_turn,
-                     to_remove_row,
-                     to_remove_col,
-                     to_remove_p,
-                     k_number_to_remove);
-
-	ghost::Solver solver(builder);
-
-	double cost = std::numeric_limits<int>::min();
-	std::vector<int> solution;
-	/*
-	bool success = solver.fast_search( cost, solution, 1 );
-	/*/
-	std::vector<double> costs;
-	std::vector< std::vector<int> > solutions;
-
-	bool success = solver.complete_search( costs, solutions );
-
-	std::vector<int> best_solutions_index;
-	for( int i = 0 ; i < static_cast<int>( solutions.size() ) ; ++i )
-	{
-//		ALOG("Solution %d: [%d, (%d,%d)], score=%f", i, solutions[i][0], solutions[i][1], solutions[i][2], costs[i]);
+	State state = make_state( cpp_grid, blue_pool, red_pool, k_blue_turn, 0 );
 
-		if( cost < costs[i] )
-		{
-			best_solutions_index.clear();
-			best_solutions_index.push_back( i );
-			cost = costs[i];
-		}
-		else
-			if( cost == costs[i] )
-				best_solutions_index.push_back( i );
-	}
+	greedy_solution( state, moves_to_remove, thread_random(), costs, moves, solution );
 
-	if( !success )
+	env->SetIntArrayRegion( sol, 0, 4, solution );
+
+	return sol;
+}
+
+// Score of each possible promotion group, or -1 alone if there are no promotions
+static std::vector<double> promotion_scores( jbyte * const grid,
+                                             jboolean blue_turn,
+                                             int blue_pool_size,
+                                             int red_pool_size )
+{
+	auto groups = get_promotions( grid,
+	                              blue_turn,
+	                              blue_pool_size,
+	                              red_pool_size );
+	std::vector<double> scores;
+
+	if( groups.size() > 0 )
 	{
-		solution[0] = 42;
-		solution[1] = 0;
-		solution[2] = 0;
+		if( groups.size() == 1 )
+			scores.push_back( 1.0 );
+		else
+			scores = heuristic_promotions( grid, groups );
 	}
 	else
-	{
-		int index = rng.pick( best_solutions_index );
-		solution = solutions[index];
-	}
-	//*/
-
-	// Output: Move (Piece + Position) + Cost
-	solution.push_back(static_cast<int>(cost) );
-	jintArray sol = env->NewIntArray( 4 );
-	env->SetIntArrayRegion( sol, 0, 4, (jint *) &solution[0] );
+		scores.push_back( -1.0 );
 
-	return sol;
+	return scores;
 }
 
 JNIEXPORT jdoubleArray JNICALL
@@ -127,21 +137,7 @@ compute_promotions_cpp( JNIEnv *env,
 
 	env->GetByteArrayRegion( k_grid, 0, 36, cpp_grid );
 
-	auto groups = get_promotions( cpp_grid,
-	                              k_blue_turn,
-	                              k_blue_pool_size,
-	                              k_red_pool_size );
-	std::vector<double> scores;
-
-	if( groups.size() > 0 )
-	{
-		if( groups.size() == 1 )
-			scores.push_back( 1.0 );
-		else
-			scores = heuristic_promotions( cpp_grid, groups );
-	}
-	else
-		scores.push_back( -1.0 );
+	std::vector<double> scores = promotion_scores( cpp_grid, k_blue_turn, k_blue_pool_size, k_red_pool_size );
 
 	jdoubleArray returned_scores = env->NewDoubleArray( scores.size() );
 	env->SetDoubleArrayRegion( returned_scores, 0, scores.size(), (jdouble *) &scores[0] );
@@ -149,9 +145,90 @@ compute_promotions_cpp( JNIEnv *env,
 	return returned_scores;
 }
 
+/**********************/
+/*** Direct buffers ***/
+/**********************/
+// Entry points ending with _direct read their inputs from a caller-owned direct ByteBuffer and
+// write their outputs into another one, in native byte order, to spare JNI copies and allocations.
+// Input layout, as written by NativeBuffers.kt:
+// grid (36 bytes), numbers of Po and Bo in the blue pool then in the red pool, blue turn,
+// number of moves to remove, then the (piece, row, column) of each move to remove.
+constexpr int DIRECT_POOLS = 36;
+constexpr int DIRECT_BLUE_TURN = 40;
+constexpr int DIRECT_NUMBER_TO_REMOVE = 41;
+constexpr int DIRECT_TO_REMOVE = 42;
+constexpr int DIRECT_INPUT_SIZE = DIRECT_TO_REMOVE + 3 * NUMBER_MOVE_SLOTS;
+
+// Return the buffer content if it holds at least size bytes, nullptr otherwise
+static jbyte *direct_buffer( JNIEnv *env, jobject k_buffer, jlong size )
+{
+	auto buffer = static_cast<jbyte *>( env->GetDirectBufferAddress( k_buffer ) );
+	if( buffer == nullptr || env->GetDirectBufferCapacity( k_buffer ) < size )
+		return nullptr;
+
+	return buffer;
+}
+
+// Read the state from input into state. Return false, leaving state unchanged, if a cell or a pool count is out of range:
+// they index the Zobrist keys, so callers must then answer as if no moves could be played.
+static bool read_direct_state( jbyte *input, State &state )
+{
+	if( !is_valid_grid( input ) )
+		return false;
+
+	for( int i = DIRECT_POOLS ; i < DIRECT_POOLS + 4 ; ++i )
+		if( input[i] < 0 || input[i] > 8 )
+			return false;
+
+	Pool blue_pool{ input[ DIRECT_POOLS ], input[ DIRECT_POOLS + 1 ] };
+	Pool red_pool{ input[ DIRECT_POOLS + 2 ], input[ DIRECT_POOLS + 3 ] };
+
+	state = make_state( input, blue_pool, red_pool, static_cast<jboolean>( input[ DIRECT_BLUE_TURN ] != 0 ), 0 );
+	return true;
+}
+
+static void read_direct_moves_to_remove( const jbyte *input, std::vector<Move> &moves_to_remove )
+{
+	int number_to_remove = std::min( static_cast<int>( input[ DIRECT_NUMBER_TO_REMOVE ] ), NUMBER_MOVE_SLOTS );
+
+	moves_to_remove.clear();
+	for( int i = 0 ; i < number_to_remove ; ++i )
+	{
+		const jbyte *move = input + DIRECT_TO_REMOVE + 3*i;
+		moves_to_remove.emplace_back( move[0], move[1], move[2] );
+	}
+}
+
 /************/
 /*** MCTS ***/
 /************/
+// Sessions (see session.hpp) live from create_session to delete_session, and are given back to the calls using them
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_fr_richoux_pobo_engine_ai_MCTS_1GHOST_00024Companion_create_1session( JNIEnv *env,
+                                                                          jobject thiz )
+{
+	return reinterpret_cast<jlong>( new Session() );
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_fr_richoux_pobo_engine_ai_MCTS_1GHOST_00024Companion_seed_1native_1random( JNIEnv *env,
+                                                                               jobject thiz,
+                                                                               jlong k_seed )
+{
+	seed_random( static_cast<std::uint64_t>( k_seed ) );
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_fr_richoux_pobo_engine_ai_MCTS_1GHOST_00024Companion_delete_1session( JNIEnv *env,
+                                                                          jobject thiz,
+                                                                          jlong k_session )
+{
+	delete reinterpret_cast<Session *>( k_session );
+}
+
 extern "C"
 JNIEXPORT jintArray JNICALL
 Java_fr_richoux_pobo_engine_ai_MCTS_1GHOST_00024Companion_ghost_1solver_1call( JNIEnv *env,
@@ -193,107 +270,47 @@ Java_fr_richoux_pobo_engine_ai_MCTS_1GHOST_00024Companion_ghost_1solver_1call_1f
 																						 jboolean k_blue_turn,
 																						 jint k_number_preselected_actions )
 {
-	randutils::mt19937_rng rng;
+	Random &rng = thread_random();
 
 	// Inputs //
 	jbyte cpp_grid[36];
-	jbyte blue_pool[k_blue_pool_size];
-	jbyte red_pool[k_red_pool_size];
-
 	env->GetByteArrayRegion( k_grid, 0, 36, cpp_grid );
-	env->GetByteArrayRegion( k_blue_pool, 0, k_blue_pool_size, blue_pool );
-	env->GetByteArrayRegion( k_red_pool, 0, k_red_pool_size, red_pool );
 
-	// Move search //
-	Builder builder( cpp_grid,
-	                 blue_pool,
-	                 k_blue_pool_size,
-	                 red_pool,
-	                 k_red_pool_size,
-	                 k_blue_turn );
-
-	ghost::Solver solver(builder);
-
-	double cost;
-	std::vector<int> solution( 3 * k_number_preselected_actions );
-	std::vector<double> costs;
-	std::vector< std::vector<int> > solutions;
-
-	bool success = solver.complete_search( costs, solutions );
-
-	/*** For debug purpose only ***/
-//	for( int i = 0; i < static_cast<int>( solutions.size()); ++i )
-//	{
-//		ALOG("Solution %d: [%d, (%c,%d)], score=%f",
-//		     i,
-//		     solutions[i][0],
-//		     'a'+solutions[i][2],
-//		     6-solutions[i][1],
-//		     costs[i] );
-//	}
-
-	std::vector<int> best_solutions_index;
-	while( best_solutions_index.size() < k_number_preselected_actions )
+	Pool blue_pool = get_pool( env, k_blue_pool, k_blue_pool_size );
+	Pool red_pool = get_pool( env, k_red_pool, k_red_pool_size );
+
+	// there are at most NUMBER_MOVE_SLOTS moves
+	int number_preselected_actions = std::clamp( k_number_preselected_actions, 0, NUMBER_MOVE_SLOTS );
+
+	// Move search, no moves from an invalid grid //
+	std::vector<Move> moves;
+	if( is_valid_grid( cpp_grid ) )
 	{
-		std::vector<int> solutions_index;
-		cost = std::numeric_limits<int>::min();
-		for( int i = 0; i < static_cast<int>( solutions.size()); ++i )
-		{
-			if( std::find( best_solutions_index.begin(), best_solutions_index.end(), i ) != best_solutions_index.end())
-				continue;
-
-			if( cost < costs[ i ] )
-			{
-				solutions_index.clear();
-				solutions_index.push_back( i );
-				cost = costs[ i ];
-			}
-			else
-				if( cost == costs[ i ] )
-					solutions_index.push_back( i );
-		}
+		State state = make_state( cpp_grid, blue_pool, red_pool, k_blue_turn, 0 );
+		moves = preselected_moves( state, number_preselected_actions, rng );
+	}
 
-		if( best_solutions_index.size() + solutions_index.size() <= k_number_preselected_actions )
-			std::copy( solutions_index.begin(), solutions_index.end(),std::back_inserter( best_solutions_index ) );
-		else
+	// a move of piece 42 tells there are no more moves
+	jint solution[ 3 * NUMBER_MOVE_SLOTS ];
+	for( int i = 0; i < number_preselected_actions; ++i )
+		if( i < static_cast<int>( moves.size() ) )
 		{
-			rng.shuffle(solutions_index );
-			std::copy( solutions_index.begin(),
-								 solutions_index.begin() + (k_number_preselected_actions - best_solutions_index.size()),
-								 std::back_inserter( best_solutions_index ));
+			solution[ 3*i ] = moves[i].piece;
+			solution[ 3*i + 1 ] = moves[i].row;
+			solution[ 3*i + 2 ] = moves[i].col;
+			TRACE_SOLVER( "Solution %d: [%d, (%c,%d)]", i, moves[i].piece, 'a'+moves[i].col, 6-moves[i].row );
 		}
-	}
-
-	if( !success )
-	{
-//		ALOG("Error");
-		for( int i = 0; i < k_number_preselected_actions; ++i )
+		else
 		{
 			solution[ 3*i ] = 42;
 			solution[ 3*i + 1 ] = 0;
 			solution[ 3*i + 2 ] = 0;
 		}
-	}
-	else
-	{
-//		ALOG("Success");
-		for( int i = 0; i < k_number_preselected_actions ; ++i )
-		{
-			solution[ 3*i ] = solutions[ best_solutions_index[i] ][0];
-			solution[ 3*i + 1 ] = solutions[ best_solutions_index[i] ][1];
-			solution[ 3*i + 2 ] = solutions[ best_solutions_index[i] ][2];
-//			ALOG("Solution %d: [%d, (%c,%d)], score=%f",
-//					 best_solutions_index[i],
-//					 solutions[best_solutions_index[i]][0],
-//					 'a'+solutions[best_solutions_index[i]][2],
-//					 6-solutions[best_solutions_index[i]][1],
-//					 costs[best_solutions_index[i]] );
-		}
-	}
 
-	// Output: Piece + Row + Column + Cost, k_number_preselected_actions times
-	jintArray sol = env->NewIntArray( 3*k_number_preselected_actions );
-	env->SetIntArrayRegion( sol, 0, 3*k_number_preselected_actions, (jint *) &solution[0] );
+	// Output: Piece + Row + Column, number_preselected_actions times
+	jintArray sol = env->NewIntArray( 3*number_preselected_actions );
+	if( number_preselected_actions > 0 )
+		env->SetIntArrayRegion( sol, 0, 3*number_preselected_actions, solution );
 
 	return sol;
 }
@@ -310,23 +327,49 @@ Java_fr_richoux_pobo_engine_ai_MCTS_1GHOST_00024Companion_heuristic_1state_1cpp(
 																					jint k_red_pool_size )
 {
 	jbyte cpp_grid[36];
-	jbyte blue_pool[k_blue_pool_size];
-	jbyte red_pool[k_red_pool_size];
-
 	env->GetByteArrayRegion( k_grid, 0, 36, cpp_grid );
-	env->GetByteArrayRegion( k_blue_pool, 0, k_blue_pool_size, blue_pool );
-	env->GetByteArrayRegion( k_red_pool, 0, k_red_pool_size, red_pool );
+
+	Pool blue_pool = get_pool( env, k_blue_pool, k_blue_pool_size );
+	Pool red_pool = get_pool( env, k_red_pool, k_red_pool_size );
 
 	jdouble score = heuristic_state( cpp_grid,
 	                                 k_blue_turn,
 	                                 blue_pool,
-	                                 k_blue_pool_size,
-	                                 red_pool,
-	                                 k_red_pool_size );
+	                                 red_pool );
 
 	return score;
 }
 
+extern "C"
+JNIEXPORT jdoubleArray JNICALL
+Java_fr_richoux_pobo_engine_ai_MCTS_1GHOST_00024Companion_score_1moves_1cpp( JNIEnv *env,
+                                                                            jobject thiz,
+                                                                            jbyteArray k_grid,
+                                                                            jbyteArray k_blue_pool,
+                                                                            jbyteArray k_red_pool,
+                                                                            jint k_blue_pool_size,
+                                                                            jint k_red_pool_size,
+                                                                            jboolean k_blue_turn )
+{
+	jbyte cpp_grid[36];
+	env->GetByteArrayRegion( k_grid, 0, 36, cpp_grid );
+
+	Pool blue_pool = get_pool( env, k_blue_pool, k_blue_pool_size );
+	Pool red_pool = get_pool( env, k_red_pool, k_red_pool_size );
+
+	// Output: one score per move slot, NaN for illegal moves (all of them if the grid is not valid)
+	jdouble scores[ NUMBER_MOVE_SLOTS ];
+	if( is_valid_grid( cpp_grid ) )
+		score_moves( make_state( cpp_grid, blue_pool, red_pool, k_blue_turn, 0 ), scores );
+	else
+		std::fill( std::begin( scores ), std::end( scores ), std::numeric_limits<double>::quiet_NaN() );
+
+	jdoubleArray k_scores = env->NewDoubleArray( NUMBER_MOVE_SLOTS );
+	env->SetDoubleArrayRegion( k_scores, 0, NUMBER_MOVE_SLOTS, scores );
+
+	return k_scores;
+}
+
 extern "C"
 JNIEXPORT jdoubleArray JNICALL
 Java_fr_richoux_pobo_engine_ai_MCTS_1GHOST_00024Companion_compute_1promotions_1cpp( JNIEnv *env,
@@ -345,6 +388,246 @@ Java_fr_richoux_pobo_engine_ai_MCTS_1GHOST_00024Companion_compute_1promotions_1c
 }
 
 
+extern "C"
+JNIEXPORT void JNICALL
+Java_fr_richoux_pobo_engine_ai_MCTS_1GHOST_00024Companion_ghost_1solver_1call_1direct( JNIEnv *env,
+                                                                                       jobject thiz,
+                                                                                       jlong k_session,
+                                                                                       jobject k_input,
+                                                                                       jobject k_output )
+{
+	auto session = reinterpret_cast<Session *>( k_session );
+	jbyte *input = direct_buffer( env, k_input, DIRECT_INPUT_SIZE );
+	jbyte *output = direct_buffer( env, k_output, 4 * sizeof( jint ) );
+	if( input == nullptr || output == nullptr )
+		return;
+
+	// Output: Move (Piece + Position) + Cost, no moves without a session or a valid state
+	jint solution[4] = { 42, 0, 0, 0 };
+	State state;
+	if( session != nullptr && read_direct_state( input, state ) )
+	{
+		read_direct_moves_to_remove( input, session->moves_to_remove() );
+		session->greedy_solution( state, solution );
+	}
+	std::memcpy( output, solution, sizeof( solution ) );
+}
+
+extern "C"
+JNIEXPORT jdouble JNICALL
+Java_fr_richoux_pobo_engine_ai_MCTS_1GHOST_00024Companion_playout_1direct( JNIEnv *env,
+                                                                          jobject thiz,
+                                                                          jlong k_session,
+                                                                          jobject k_input,
+                                                                          jboolean k_perspective_is_blue,
+                                                                          jint k_first_n_strategy,
+                                                                          jint k_playout_depth,
+                                                                          jdouble k_discount_score )
+{
+	auto session = reinterpret_cast<Session *>( k_session );
+	jbyte *input = direct_buffer( env, k_input, DIRECT_INPUT_SIZE );
+	State state;
+	if( session == nullptr || input == nullptr || !read_direct_state( input, state ) )
+		return 0.;
+
+	return playout( state,
+	                k_perspective_is_blue,
+	                k_first_n_strategy,
+	                k_playout_depth,
+	                k_discount_score,
+	                session->rng() );
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_fr_richoux_pobo_engine_ai_MCTS_1GHOST_00024Companion_playouts_1direct( JNIEnv *env,
+                                                                           jobject thiz,
+                                                                           jlong k_session,
+                                                                           jobject k_input,
+                                                                           jobject k_output,
+                                                                           jint k_number_playouts,
+                                                                           jboolean k_perspective_is_blue,
+                                                                           jint k_first_n_strategy,
+                                                                           jint k_playout_depth,
+                                                                           jdouble k_discount_score,
+                                                                           jint k_number_threads )
+{
+	auto session = reinterpret_cast<Session *>( k_session );
+	jbyte *input = direct_buffer( env, k_input, DIRECT_INPUT_SIZE );
+	jbyte *output = direct_buffer( env, k_output, std::max( 0, k_number_playouts ) * sizeof( jdouble ) );
+	State state;
+	if( session == nullptr || input == nullptr || output == nullptr || !read_direct_state( input, state ) )
+		return 0;
+
+	auto &scores = session->playouts( state,
+	                                  k_perspective_is_blue,
+	                                  k_first_n_strategy,
+	                                  k_playout_depth,
+	                                  k_discount_score,
+	                                  k_number_playouts,
+	                                  std::clamp( k_number_threads, 1, MAX_NUMBER_THREADS ) );
+
+	// Output: the score of each playout
+	std::memcpy( output, scores.data(), scores.size() * sizeof( jdouble ) );
+	return static_cast<jint>( scores.size() );
+}
+
+extern "C"
+JNIEXPORT jdouble JNICALL
+Java_fr_richoux_pobo_engine_ai_MCTS_1GHOST_00024Companion_heuristic_1state_1direct( JNIEnv *env,
+                                                                                    jobject thiz,
+                                                                                    jobject k_input )
+{
+	jbyte *input = direct_buffer( env, k_input, DIRECT_INPUT_SIZE );
+	State state;
+	if( input == nullptr || !read_direct_state( input, state ) )
+		return 0.;
+
+	return heuristic_state( state.grid, state.blue_turn, state.blue_pool, state.red_pool );
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_fr_richoux_pobo_engine_ai_MCTS_1GHOST_00024Companion_score_1moves_1direct( JNIEnv *env,
+                                                                                jobject thiz,
+                                                                                jobject k_input,
+                                                                                jobject k_output )
+{
+	jbyte *input = direct_buffer( env, k_input, DIRECT_INPUT_SIZE );
+	jbyte *output = direct_buffer( env, k_output, NUMBER_MOVE_SLOTS * sizeof( jdouble ) );
+	if( input == nullptr || output == nullptr )
+		return;
+
+	// Output: one score per move slot, NaN for illegal moves (all of them if the state is not valid)
+	jdouble scores[ NUMBER_MOVE_SLOTS ];
+	State state;
+	if( read_direct_state( input, state ) )
+		score_moves( state, scores );
+	else
+		std::fill( std::begin( scores ), std::end( scores ), std::numeric_limits<double>::quiet_NaN() );
+	std::memcpy( output, scores, sizeof( scores ) );
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_fr_richoux_pobo_engine_ai_MCTS_1GHOST_00024Companion_preselected_1moves_1direct( JNIEnv *env,
+                                                                                     jobject thiz,
+                                                                                     jlong k_session,
+                                                                                     jobject k_input,
+                                                                                     jobject k_output,
+                                                                                     jint k_number_preselected_actions )
+{
+	auto session = reinterpret_cast<Session *>( k_session );
+	jbyte *input = direct_buffer( env, k_input, DIRECT_INPUT_SIZE );
+	jbyte *output = direct_buffer( env, k_output, NUMBER_MOVE_SLOTS * sizeof( jint ) );
+	State state;
+	if( session == nullptr || input == nullptr || output == nullptr || !read_direct_state( input, state ) )
+		return 0;
+
+	// there are at most NUMBER_MOVE_SLOTS moves
+	auto moves = preselected_moves( state, std::clamp( k_number_preselected_actions, 0, NUMBER_MOVE_SLOTS ), session->rng() );
+
+	// Output: the move slot (see move_slot in move_generator.hpp) of each preselected move, best first
+	jint slots[ NUMBER_MOVE_SLOTS ];
+	for( int i = 0 ; i < static_cast<int>( moves.size() ) ; ++i )
+		slots[i] = move_slot( moves[i].piece, moves[i].row, moves[i].col );
+
+	std::memcpy( output, slots, moves.size() * sizeof( jint ) );
+	return static_cast<jint>( moves.size() );
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_fr_richoux_pobo_engine_ai_MCTS_1GHOST_00024Companion_compute_1promotions_1direct( JNIEnv *env,
+                                                                                      jobject thiz,
+                                                                                      jobject k_input,
+                                                                                      jobject k_output )
+{
+	jbyte *input = direct_buffer( env, k_input, DIRECT_INPUT_SIZE );
+	State state;
+	if( input == nullptr || !read_direct_state( input, state ) )
+		return 0;
+
+	std::vector<double> scores = promotion_scores( state.grid,
+	                                               state.blue_turn,
+	                                               state.blue_pool.size(),
+	                                               state.red_pool.size() );
+
+	// Output: as many scores as groups that can be promoted (-1 alone if none), not written if they do not fit
+	jbyte *output = direct_buffer( env, k_output, scores.size() * sizeof( jdouble ) );
+	if( output == nullptr )
+		return 0;
+
+	std::memcpy( output, scores.data(), scores.size() * sizeof( jdouble ) );
+	return static_cast<jint>( scores.size() );
+}
+
+extern "C"
+JNIEXPORT jintArray JNICALL
+Java_fr_richoux_pobo_engine_ai_MCTS_1GHOST_00024Companion_mcts_1cpp( JNIEnv *env,
+                                                                     jobject thiz,
+                                                                     jlong k_session,
+                                                                     jbyteArray k_grid,
+                                                                     jbyteArray k_blue_pool,
+                                                                     jbyteArray k_red_pool,
+                                                                     jint k_blue_pool_size,
+                                                                     jint k_red_pool_size,
+                                                                     jboolean k_blue_turn,
+                                                                     jint k_move_number,
+                                                                     jboolean k_ai_is_blue,
+                                                                     jint k_ai_level,
+                                                                     jlong k_timeout_in_ms,
+                                                                     jint k_number_preselected_actions,
+                                                                     jboolean k_expansions_with_GHOST,
+                                                                     jint k_first_n_strategy,
+                                                                     jint k_playout_depth,
+                                                                     jint k_action_masking_time,
+                                                                     jdouble k_discount_score,
+                                                                     jint k_number_threads )
+{
+	// Output: Move (Piece + Position), no moves without a session or a valid grid
+	jint solution[3] = { 42, 0, 0 };
+	jintArray sol = env->NewIntArray( 3 );
+
+	// Inputs //
+	jbyte cpp_grid[36];
+	env->GetByteArrayRegion( k_grid, 0, 36, cpp_grid );
+
+	auto session = reinterpret_cast<Session *>( k_session );
+	if( session == nullptr || !is_valid_grid( cpp_grid ) )
+	{
+		env->SetIntArrayRegion( sol, 0, 3, solution );
+		return sol;
+	}
+
+	Pool blue_pool = get_pool( env, k_blue_pool, k_blue_pool_size );
+	Pool red_pool = get_pool( env, k_red_pool, k_red_pool_size );
+
+	State state = make_state( cpp_grid,
+	                          blue_pool,
+	                          red_pool,
+	                          k_blue_turn,
+	                          k_move_number );
+
+	// Tree search, kept by the session from one move to the next //
+	MCTS &mcts = session->mcts( k_number_preselected_actions,
+	                            k_expansions_with_GHOST,
+	                            k_first_n_strategy,
+	                            k_playout_depth,
+	                            k_action_masking_time,
+	                            k_discount_score,
+	                            std::clamp( k_number_threads, 1, MAX_NUMBER_THREADS ) );
+
+	Move move = mcts.select_move( state, k_ai_is_blue, k_ai_level, k_timeout_in_ms );
+
+	solution[0] = move.piece;
+	solution[1] = move.row;
+	solution[2] = move.col;
+	env->SetIntArrayRegion( sol, 0, 3, solution );
+
+	return sol;
+}
+
 /***********************/
 /*** Pure Heuristics ***/
 /***********************/
@@ -392,4 +675,58 @@ Java_fr_richoux_pobo_engine_ai_PureHeuristics_00024Companion_compute_1promotions
 	                               k_blue_turn,
 	                               k_blue_pool_size,
 	                               k_red_pool_size );
-}
\ No newline at end of file
+}
+
+/******************/
+/*** Alpha-Beta ***/
+/******************/
+extern "C"
+JNIEXPORT jdoubleArray JNICALL
+Java_fr_richoux_pobo_engine_ai_AlphaBeta_00024Companion_alpha_1beta_1cpp( JNIEnv *env,
+                                                                         jobject thiz,
+                                                                         jlong k_session,
+                                                                         jbyteArray k_grid,
+                                                                         jbyteArray k_blue_pool,
+                                                                         jbyteArray k_red_pool,
+                                                                         jint k_blue_pool_size,
+                                                                         jint k_red_pool_size,
+                                                                         jboolean k_blue_turn,
+                                                                         jint k_move_number,
+                                                                         jlong k_timeout_in_ms,
+                                                                         jint k_max_depth )
+{
+	// Inputs //
+	jbyte cpp_grid[36];
+	env->GetByteArrayRegion( k_grid, 0, 36, cpp_grid );
+
+	// no results without a session or from an invalid grid, as if no search finished in time
+	auto session = reinterpret_cast<Session *>( k_session );
+	if( session == nullptr || !is_valid_grid( cpp_grid ) )
+		return env->NewDoubleArray( 0 );
+
+	Pool blue_pool = get_pool( env, k_blue_pool, k_blue_pool_size );
+	Pool red_pool = get_pool( env, k_red_pool, k_red_pool_size );
+
+	State state = make_state( cpp_grid,
+	                          blue_pool,
+	                          red_pool,
+	                          k_blue_turn,
+	                          k_move_number );
+
+	// Search, kept by the session from one move to the next //
+	SearchResult result = session->alpha_beta().search( state, k_timeout_in_ms, k_max_depth );
+
+	// Output: score, depth, then the principal variation as (piece, row, col) triples
+	std::vector<jdouble> output = { result.score, static_cast<jdouble>( result.depth ) };
+	for( auto &move : result.principal_variation )
+	{
+		output.push_back( move.piece );
+		output.push_back( move.row );
+		output.push_back( move.col );
+	}
+
+	jdoubleArray k_output = env->NewDoubleArray( static_cast<jsize>( output.size() ) );
+	env->SetDoubleArrayRegion( k_output, 0, static_cast<jsize>( output.size() ), output.data() );
+
+	return k_output;
+}
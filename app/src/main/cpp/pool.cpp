@@ -0,0 +1,11 @@
+#include "pool.hpp"
+
+Pool make_pool( const jbyte * const pool, jint pool_size )
+{
+	Pool counts{ 0, 0 };
+
+	for( int i = 0 ; i < pool_size ; ++i )
+		counts.add( pool[i] );
+
+	return counts;
+}
@@ -0,0 +1,25 @@
+#ifndef POBO_POOL_HPP
+#define POBO_POOL_HPP
+
+#include "jni_types.hpp"
+
+// Pieces a player has in hand: since pieces in a pool are interchangeable,
+// only the number of Po and Bo are stored.
+struct Pool
+{
+	jbyte po;
+	jbyte bo;
+
+	int size() const { return po + bo; }
+	bool is_empty() const { return po + bo == 0; }
+
+	// piece is 1 for Po, 2 for Bo
+	bool has( int piece ) const { return ( piece == 1 ? po : bo ) > 0; }
+	void add( int piece, int number = 1 ) { ( piece == 1 ? po : bo ) += number; }
+	void remove( int piece ) { --( piece == 1 ? po : bo ); }
+};
+
+// Count pieces from a pool array as sent through JNI
+Pool make_pool( const jbyte * const pool, jint pool_size );
+
+#endif //POBO_POOL_HPP
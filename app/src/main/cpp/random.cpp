@@ -0,0 +1,66 @@
+#include <atomic>
+#include <random>
+
+#include "random.hpp"
+
+namespace
+{
+	// seed_random state: thread generators check epoch to know they must be seeded again
+	std::atomic<std::uint64_t> epoch( 0 );
+	std::atomic<bool> is_seeded( false );
+	std::atomic<std::uint64_t> engine_seed( 0 );
+	std::atomic<std::uint64_t> number_seeded_threads( 0 );
+
+	std::uint64_t splitmix64( std::uint64_t &x )
+	{
+		std::uint64_t z = ( x += 0x9e3779b97f4a7c15 );
+		z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9;
+		z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111eb;
+		return z ^ ( z >> 31 );
+	}
+
+	std::uint64_t thread_seed()
+	{
+		if( is_seeded )
+		{
+			std::uint64_t x = engine_seed + number_seeded_threads++;
+			return splitmix64( x );
+		}
+
+		std::random_device entropy;
+		return ( static_cast<std::uint64_t>( entropy() ) << 32 ) ^ entropy();
+	}
+}
+
+Random::Random()
+	: Random( thread_random()() )
+{ }
+
+Random::Random( std::uint64_t seed )
+{
+	// splitmix64 output is never all zeros over 4 numbers, the only forbidden xoshiro state
+	for( auto &word : _state )
+		word = splitmix64( seed );
+}
+
+Random &thread_random()
+{
+	thread_local std::uint64_t thread_epoch = epoch;
+	thread_local Random generator( thread_seed() );
+
+	if( thread_epoch != epoch )
+	{
+		thread_epoch = epoch;
+		generator = Random( thread_seed() );
+	}
+
+	return generator;
+}
+
+void seed_random( std::uint64_t seed )
+{
+	engine_seed = seed;
+	number_seeded_threads = 0;
+	is_seeded = true;
+	++epoch;
+}
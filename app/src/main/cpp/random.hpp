@@ -0,0 +1,69 @@
+#ifndef POBO_RANDOM_HPP
+#define POBO_RANDOM_HPP
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+
+// xoshiro256** generator (see https://prng.di.unimi.it/), for all random choices of the native engine:
+// 32 bytes of state and a few operations per number, where randutils::mt19937_rng gathers system entropy
+// and initialises 2.5KB of Mersenne Twister state on construction.
+// Generators are not shared between threads: each search thread has its own.
+class Random
+{
+	std::uint64_t _state[4];
+
+	static std::uint64_t rotate_left( std::uint64_t x, int k ) { return ( x << k ) | ( x >> ( 64 - k ) ); }
+
+public:
+	using result_type = std::uint64_t;
+
+	// Seeded from the generator of the calling thread (see thread_random)
+	Random();
+
+	// Same numbers for the same seed
+	explicit Random( std::uint64_t seed );
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+	result_type operator()()
+	{
+		std::uint64_t result = rotate_left( _state[1] * 5, 7 ) * 9;
+		std::uint64_t t = _state[1] << 17;
+
+		_state[2] ^= _state[0];
+		_state[3] ^= _state[1];
+		_state[1] ^= _state[2];
+		_state[0] ^= _state[3];
+		_state[2] ^= t;
+		_state[3] = rotate_left( _state[3], 45 );
+
+		return result;
+	}
+
+	// Integer in [min, max], by multiplying the 32 high bits of a number with the range size
+	int uniform( int min, int max )
+	{
+		std::uint64_t range = static_cast<std::uint64_t>( max - min ) + 1;
+		return min + static_cast<int>( ( ( (*this)() >> 32 ) * range ) >> 32 );
+	}
+
+	// Uniformly random element of a non-empty container
+	template<typename Container>
+	auto pick( Container &container ) -> decltype( *std::begin( container ) )
+	{
+		return *std::next( std::begin( container ), uniform( 0, static_cast<int>( std::size( container ) ) - 1 ) );
+	}
+};
+
+// Generator of the calling thread, for random choices made outside of a search owning a generator
+// (e.g., promotion tie-breaks), and seeding generators built without an explicit seed.
+Random &thread_random();
+
+// Seed the engine for reproducible runs: thread generators are seeded again from seed, in the order threads
+// first use them after this call, instead of from system entropy. A search running on one thread, with a fixed
+// number of iterations, then makes the same choices from one run to another.
+void seed_random( std::uint64_t seed );
+
+#endif //POBO_RANDOM_HPP
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <limits>
+
+#include "session.hpp"
+#include "move_generator.hpp"
+#include "trace.hpp"
+
+Session::Session()
+	: _batch_state(),
+	  _batch_perspective_is_blue( false ),
+	  _batch_first_n_strategy( 0 ),
+	  _batch_playout_depth( 0 ),
+	  _batch_discount_score( 1.0 ),
+	  _next_playout( 0 )
+{ }
+
+void greedy_solution( const State &state,
+                      const std::vector<Move> &moves_to_remove,
+                      Random &rng,
+                      std::vector<double> &costs,
+                      std::vector<Move> &moves,
+                      jint *solution )
+{
+	double cost = std::numeric_limits<int>::min();
+
+	bool success = best_moves( state, moves_to_remove, 1, costs, moves );
+
+	for( int i = 0 ; i < static_cast<int>( moves.size() ) ; ++i )
+		TRACE_SOLVER( "Best solution %d: [%d, (%d,%d)], score=%f", i, moves[i].piece, moves[i].row, moves[i].col, costs[i] );
+
+	if( !success )
+	{
+		solution[0] = 42;
+		solution[1] = 0;
+		solution[2] = 0;
+	}
+	else
+	{
+		auto &move = rng.pick( moves );
+		solution[0] = move.piece;
+		solution[1] = move.row;
+		solution[2] = move.col;
+		cost = costs[0];
+	}
+
+	solution[3] = static_cast<jint>( cost );
+}
+
+void Session::greedy_solution( const State &state, jint *solution )
+{
+	::greedy_solution( state, _moves_to_remove, _rng, _costs, _moves, solution );
+}
+
+MCTS &Session::mcts( int number_preselected_actions,
+                     bool expansions_with_ghost,
+                     int first_n_strategy,
+                     int playout_depth,
+                     int action_masking_time,
+                     double discount_score,
+                     int number_threads )
+{
+	if( !_mcts || !_mcts->has_parameters( number_preselected_actions,
+	                                      expansions_with_ghost,
+	                                      first_n_strategy,
+	                                      playout_depth,
+	                                      action_masking_time,
+	                                      discount_score,
+	                                      number_threads ) )
+		_mcts = std::make_unique<MCTS>( _workers,
+		                                number_preselected_actions,
+		                                expansions_with_ghost,
+		                                first_n_strategy,
+		                                playout_depth,
+		                                action_masking_time,
+		                                discount_score,
+		                                number_threads );
+
+	return *_mcts;
+}
+
+AlphaBeta &Session::alpha_beta()
+{
+	if( !_alpha_beta )
+		_alpha_beta = std::make_unique<AlphaBeta>();
+
+	return *_alpha_beta;
+}
+
+void Session::run_playouts( Random &rng )
+{
+	int number_playouts = static_cast<int>( _batch_scores.size() );
+	for( int i = _next_playout++ ; i < number_playouts ; i = _next_playout++ )
+		_batch_scores[i] = playout( _batch_state,
+		                            _batch_perspective_is_blue,
+		                            _batch_first_n_strategy,
+		                            _batch_playout_depth,
+		                            _batch_discount_score,
+		                            rng );
+}
+
+const std::vector<double> &Session::playouts( const State &start,
+                                              jboolean perspective_is_blue,
+                                              int first_n_strategy,
+                                              int playout_depth,
+                                              double discount_score,
+                                              int number_playouts,
+                                              int number_threads )
+{
+	_batch_state = start;
+	_batch_perspective_is_blue = perspective_is_blue;
+	_batch_first_n_strategy = first_n_strategy;
+	_batch_playout_depth = playout_depth;
+	_batch_discount_score = discount_score;
+	_batch_scores.assign( std::max( 0, number_playouts ), 0.0 );
+	_next_playout = 0;
+
+	// no need for more threads than playouts
+	_workers.run( std::max( 1, std::min( number_threads, number_playouts ) ),
+	              _rng,
+	              [this]( Random &rng ) { run_playouts( rng ); } );
+
+	return _batch_scores;
+}
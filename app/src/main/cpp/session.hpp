@@ -0,0 +1,91 @@
+#ifndef POBO_SESSION_HPP
+#define POBO_SESSION_HPP
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "alpha_beta.hpp"
+#include "game.hpp"
+#include "mcts.hpp"
+#include "random.hpp"
+#include "worker_pool.hpp"
+
+// Engine state kept by the JNI layer across the calls of a whole game, so that calls in the MCTS loops
+// do not set it up again: the random generator, seeded once, and buffers reused from one call to the next.
+// Kotlin holds it as an opaque jlong handle (see create_session in pobo.cpp).
+class Session
+{
+	Random _rng;
+	std::vector<Move> _moves_to_remove;
+	std::vector<double> _costs;
+	std::vector<Move> _moves;
+
+	// Workers of playout batches and of the MCTS: each one keeps its random generator
+	// and its evaluation table (see evaluation_table) from one run to the next.
+	WorkerPool _workers;
+
+	// Current batch, only written while no workers are running
+	State _batch_state;
+	jboolean _batch_perspective_is_blue;
+	int _batch_first_n_strategy;
+	int _batch_playout_depth;
+	double _batch_discount_score;
+	std::vector<double> _batch_scores;
+	std::atomic<int> _next_playout;
+
+	// Tree search of the native MCTS, with its node pool, searching on _workers
+	std::unique_ptr<MCTS> _mcts;
+
+	// Alpha-beta search, with its transposition table
+	std::unique_ptr<AlphaBeta> _alpha_beta;
+
+	// Run playouts of the current batch until there are none left
+	void run_playouts( Random &rng );
+
+public:
+	Session();
+
+	Random &rng() { return _rng; }
+
+	// Moves the next greedy_solution call must not pick, filled by the caller
+	std::vector<Move> &moves_to_remove() { return _moves_to_remove; }
+
+	// See greedy_solution below, with the session's generator, buffers and moves to remove
+	void greedy_solution( const State &state, jint *solution );
+
+	// Tree search kept from one move to the next, built again only if its parameters change (see MCTS)
+	MCTS &mcts( int number_preselected_actions,
+	            bool expansions_with_ghost,
+	            int first_n_strategy,
+	            int playout_depth,
+	            int action_masking_time,
+	            double discount_score,
+	            int number_threads );
+
+	// Alpha-beta search kept from one move to the next, so that its transposition table is allocated once
+	// and its entries are reused by the next searches
+	AlphaBeta &alpha_beta();
+
+	// Run number_playouts playouts (see playout in mcts.hpp) from start on number_threads threads,
+	// the calling one included, and return their scores. Scores are valid until the next call.
+	const std::vector<double> &playouts( const State &start,
+	                                     jboolean perspective_is_blue,
+	                                     int first_n_strategy,
+	                                     int playout_depth,
+	                                     double discount_score,
+	                                     int number_playouts,
+	                                     int number_threads );
+};
+
+// Write one of the best moves of the player to move, but moves_to_remove, and its cost in solution,
+// as {piece, row, col, cost}, ties being broken randomly, or {42, 0, 0, cost} if no moves can be played.
+// costs and moves are buffers, filled by best_moves.
+void greedy_solution( const State &state,
+                      const std::vector<Move> &moves_to_remove,
+                      Random &rng,
+                      std::vector<double> &costs,
+                      std::vector<Move> &moves,
+                      jint *solution );
+
+#endif //POBO_SESSION_HPP
@@ -1,460 +1,148 @@
 #include "simulator.hpp"
-#include "lib/include/ghost/thirdparty/randutils.hpp"
+#include "random.hpp"
+#include "trace.hpp"
+#include "zobrist.hpp"
 
-#include <android/log.h>
-//*
-#define ALOG(...)
-/*/
-#define ALOG( ... ) __android_log_print(ANDROID_LOG_INFO, "pobotag C++", __VA_ARGS__)
-//*/
+static constexpr jbyte OFF_BOARD = -1;
 
-void simulate_move( const std::vector<ghost::Variable *> &variables,
-                    jbyte * const simulation_grid,
-                    jboolean blue_turn,
-                    jbyte * const blue_pool,
-                    jint & blue_pool_size,
-                    jbyte * const red_pool,
-                    jint & red_pool_size )
+// For each cell: its neighbour cells, and the cells these neighbours are pushed to (or OFF_BOARD).
+// Neighbours are listed in the order top left, bottom left, left, top right, bottom right, right, top and bottom.
+struct PushTable
 {
-	jbyte v_p = variables[0]->get_value();
-	int p = v_p * (blue_turn ? -1 : 1);
-	int row = variables[1]->get_value();
-	int col = variables[2]->get_value();
-	int index = row*6 + col;
+	jbyte number_neighbours[36];
+	jbyte neighbour[36][8];
+	jbyte target[36][8];
+};
 
-	if( blue_turn )
-	{
-		int i = blue_pool_size - 1;
-		while( blue_pool[i] != v_p && i >= 0 )
-			--i;
-
-		if( i < 0 )
-			ALOG("THIS SHOULD NEVER HAPPEN: piece selected by the solver not in Blue pool");
+static constexpr PushTable make_push_table()
+{
+	constexpr int row_steps[8] = { -1, 1, 0, -1, 1, 0, -1, 1 };
+	constexpr int col_steps[8] = { -1, -1, -1, 1, 1, 1, 0, 0 };
 
-		while( i < blue_pool_size - 1 )
+	PushTable table{};
+	for( int index = 0 ; index < 36 ; ++index )
+	{
+		int count = 0;
+		for( int dir = 0 ; dir < 8 ; ++dir )
 		{
-			blue_pool[i] = blue_pool[i+1];
-			++i;
-		}
+			int row = index / 6 + row_steps[ dir ];
+			int col = index % 6 + col_steps[ dir ];
+			if( row < 0 || row > 5 || col < 0 || col > 5 )
+				continue;
 
-		blue_pool[blue_pool_size-1] = 0;
-		--blue_pool_size;
-	}
-	else
-	{
-		int i = red_pool_size - 1;
-		while( red_pool[i] != v_p && i >= 0 )
-			--i;
+			table.neighbour[ index ][ count ] = static_cast<jbyte>( row * 6 + col );
 
-		if( i < 0 )
-			ALOG("THIS SHOULD NEVER HAPPEN: piece selected by the solver not in Red pool");
+			row += row_steps[ dir ];
+			col += col_steps[ dir ];
+			if( row < 0 || row > 5 || col < 0 || col > 5 )
+				table.target[ index ][ count ] = OFF_BOARD;
+			else
+				table.target[ index ][ count ] = static_cast<jbyte>( row * 6 + col );
 
-		while( i < red_pool_size - 1 )
-		{
-			red_pool[i] = red_pool[i+1];
-			++i;
+			++count;
 		}
-
-		red_pool[red_pool_size-1] = 0;
-		--red_pool_size;
+		table.number_neighbours[ index ] = static_cast<jbyte>( count );
 	}
 
-	simulation_grid[index] = p;
-
-	if( col-1 >= 0 )
-	{
-		// Top Left
-		if( row - 1 >= 0 )
-		{
-			if( simulation_grid[ (row - 1) * 6 + col - 1 ] != 0 &&
-			    std::abs( simulation_grid[ (row - 1) * 6 + col - 1 ] ) <=
-			    std::abs( simulation_grid[ index ] ) &&
-			    (col - 2 < 0 || row - 2 < 0 || simulation_grid[ (row - 2) * 6 + col - 2 ] == 0))
-			{
-				if( col - 2 >= 0 && row - 2 >= 0 )
-				{
-					if( simulation_grid[ (row - 2) * 6 + col - 2 ] == 0 )
-						simulation_grid[ (row - 2) * 6 + col - 2 ] = simulation_grid[ (row - 1) * 6 + col - 1 ];
-				}
-				else // if a piece has been ejected out the board, we need to put it into the right pool
-				{
-					if( simulation_grid[ (row - 1) * 6 + col - 1 ] > 0 )
-					{
-						// in every case, either a Po or a Bo has been ejected out the board
-						red_pool[ red_pool_size ] = 1;
-
-						if( simulation_grid[ (row - 1) * 6 + col - 1 ] == 2 ) // if it is a Bo though
-						{
-							int i = 0;
-							while( red_pool[ i ] == 2 )
-								++i;
-							red_pool[ i ] = 2;
-						}
-
-						++red_pool_size;
-					}
-					else
-					{
-						blue_pool[ blue_pool_size ] = 1;
-
-						if( simulation_grid[ (row - 1) * 6 + col - 1 ] == -2 ) // if it is a Bo though
-						{
-							int i = 0;
-							while( blue_pool[ i ] == 2 )
-								++i;
-							blue_pool[ i ] = 2;
-						}
-
-						++blue_pool_size;
-					}
-				}
-
-				simulation_grid[ (row - 1) * 6 + col - 1 ] = 0;
-			}
-		}
+	return table;
+}
 
-		// Bottom Left
-		if( row + 1 <= 5 )
-		{
-			if( simulation_grid[ (row + 1) * 6 + col - 1 ] != 0 &&
-			    std::abs( simulation_grid[ (row + 1) * 6 + col - 1 ] ) <=
-			    std::abs( simulation_grid[ index ] ) &&
-			    (col - 2 < 0 || row + 2 > 5 || simulation_grid[ (row + 2) * 6 + col - 2 ] == 0))
-			{
-				if( col - 2 >= 0 && row + 2 <= 5 )
-				{
-					if( simulation_grid[ (row + 2) * 6 + col - 2 ] == 0 )
-						simulation_grid[ (row + 2) * 6 + col - 2 ] = simulation_grid[ (row + 1) * 6 + col - 1 ];
-				}
-				else // if a piece has been ejected out the board, we need to put it into the right pool
-				{
-					if( simulation_grid[ (row + 1) * 6 + col - 1 ] > 0 )
-					{
-						// in every case, either a Po or a Bo has been ejected out the board
-						red_pool[ red_pool_size ] = 1;
-
-						if( simulation_grid[ (row + 1) * 6 + col - 1 ] == 2 ) // if it is a Bo though
-						{
-							int i = 0;
-							while( red_pool[ i ] == 2 )
-								++i;
-							red_pool[ i ] = 2;
-						}
-
-						++red_pool_size;
-					}
-					else
-					{
-						blue_pool[ blue_pool_size ] = 1;
+static constexpr PushTable push_table = make_push_table();
 
-						if( simulation_grid[ (row + 1) * 6 + col - 1 ] == -2 ) // if it is a Bo though
-						{
-							int i = 0;
-							while( blue_pool[ i ] == 2 )
-								++i;
-							blue_pool[ i ] = 2;
-						}
+void simulate_move( const std::vector<ghost::Variable *> &variables,
+                    jbyte * const simulation_grid,
+                    jboolean blue_turn,
+                    Pool & blue_pool,
+                    Pool & red_pool )
+{
+	simulate_move( variables[0]->get_value(),
+	               variables[1]->get_value(),
+	               variables[2]->get_value(),
+	               simulation_grid,
+	               blue_turn,
+	               blue_pool,
+	               red_pool );
+}
+
+void simulate_move( int piece,
+                    int row,
+                    int col,
+                    jbyte * const simulation_grid,
+                    jboolean blue_turn,
+                    Pool & blue_pool,
+                    Pool & red_pool,
+                    std::uint64_t * const hash )
+{
+	simulate_push( piece, row, col, simulation_grid, blue_turn, blue_pool, red_pool, hash );
+	simulate_promotion( simulation_grid, blue_turn, blue_pool, red_pool, hash );
+}
 
-						++blue_pool_size;
-					}
-				}
+void simulate_push( int piece,
+                    int row,
+                    int col,
+                    jbyte * const simulation_grid,
+                    jboolean blue_turn,
+                    Pool & blue_pool,
+                    Pool & red_pool,
+                    std::uint64_t * const hash )
+{
+	jbyte v_p = piece;
+	int p = v_p * (blue_turn ? -1 : 1);
+	int index = row*6 + col;
 
-				simulation_grid[ (row + 1) * 6 + col - 1 ] = 0;
-			}
-		}
+	if( hash )
+		*hash ^= zobrist_pools( blue_pool, red_pool ) ^ zobrist_cell( index, p );
 
-		// Left
-		if( simulation_grid[ row * 6 + col - 1 ] != 0 &&
-		    std::abs( simulation_grid[ row * 6 + col - 1 ] ) <= std::abs( simulation_grid[ index ] ) &&
-		    (col - 2 < 0 || simulation_grid[ row * 6 + col - 2 ] == 0))
-		{
-			if( col - 2 >= 0 )
-			{
-				if( simulation_grid[ row * 6 + col - 2 ] == 0 )
-					simulation_grid[ row * 6 + col - 2 ] = simulation_grid[ row * 6 + col - 1 ];
-			}
-			else // if a piece has been ejected out the board, we need to put it into the right pool
-			{
-				if( simulation_grid[ row * 6 + col - 1 ] > 0 )
-				{
-					// in every case, either a Po or a Bo has been ejected out the board
-					red_pool[ red_pool_size ] = 1;
+	Pool &pool = blue_turn ? blue_pool : red_pool;
+	if( !pool.has( v_p ) )
+		TRACE_SIMULATOR("THIS SHOULD NEVER HAPPEN: piece selected by the solver not in %s pool", blue_turn ? "Blue" : "Red");
 
-					if( simulation_grid[ row * 6 + col - 1 ] == 2 ) // if it is a Bo though
-					{
-						int i = 0;
-						while( red_pool[ i ] == 2 )
-							++i;
-						red_pool[ i ] = 2;
-					}
+	pool.remove( v_p );
 
-					++red_pool_size;
-				}
-				else
-				{
-					blue_pool[ blue_pool_size ] = 1;
+	simulation_grid[index] = p;
 
-					if( simulation_grid[ row * 6 + col - 1 ] == -2 ) // if it is a Bo though
-					{
-						int i = 0;
-						while( blue_pool[ i ] == 2 )
-							++i;
-						blue_pool[ i ] = 2;
-					}
+	// a Bo pushes any piece, a Po pushes Po only, i.e., pieces with an odd value
+	const jbyte pushable = v_p == 2 ? -1 : 1;
 
-					++blue_pool_size;
-				}
-			}
-			simulation_grid[ row * 6 + col - 1 ] = 0;
-		}
-	}
+	const jbyte *neighbours = push_table.neighbour[ index ];
+	const jbyte *targets = push_table.target[ index ];
+	const int number_neighbours = push_table.number_neighbours[ index ];
 
-	if( col+1 <= 5 )
+	// neighbours and targets are disjoint: the order in which pushes are resolved does not matter
+	for( int i = 0 ; i < number_neighbours ; ++i )
 	{
-		// Top Right
-		if( row-1 >= 0 )
-		{
-			if( simulation_grid[ ( row-1 )*6 + col+1 ] != 0 &&
-			    std::abs( simulation_grid[ ( row-1 )*6 + col+1 ] ) <= std::abs( simulation_grid[ index ] ) &&
-			    ( col+2 > 5 || row-2 < 0 || simulation_grid[ ( row-2 )*6 + col+2 ] == 0 ))
-			{
-				if( col + 2 <= 5 && row - 2 >= 0 )
-				{
-					if( simulation_grid[ (row - 2) * 6 + col + 2 ] == 0 )
-						simulation_grid[ (row - 2) * 6 + col + 2 ] = simulation_grid[ (row - 1) * 6 + col + 1 ];
-				}
-				else // if a piece has been ejected out the board, we need to put it into the right pool
-				{
-					if( simulation_grid[ (row - 1) * 6 + col + 1 ] > 0 )
-					{
-						// in every case, either a Po or a Bo has been ejected out the board
-						red_pool[ red_pool_size ] = 1;
-
-						if( simulation_grid[ (row - 1) * 6 + col + 1 ] == 2 ) // if it is a Bo though
-						{
-							int i = 0;
-							while( red_pool[ i ] == 2 )
-								++i;
-							red_pool[ i ] = 2;
-						}
-
-						++red_pool_size;
-					}
-					else
-					{
-						blue_pool[ blue_pool_size ] = 1;
-
-						if( simulation_grid[ (row - 1) * 6 + col + 1 ] == -2 ) // if it is a Bo though
-						{
-							int i = 0;
-							while( blue_pool[ i ] == 2 )
-								++i;
-							blue_pool[ i ] = 2;
-						}
-
-						++blue_pool_size;
-					}
-				}
-
-				simulation_grid[ (row - 1) * 6 + col + 1 ] = 0;
-			}
-		}
-
-		// Bottom Right
-		if( row+1 <= 5 )
-		{
-			if( simulation_grid[ ( row+1 )*6 + col+1 ] != 0 &&
-			    std::abs( simulation_grid[ ( row+1 )*6 + col+1 ] ) <= std::abs( simulation_grid[ index ] ) &&
-			    ( col+2 > 5 || row+2 > 5 || simulation_grid[ ( row+2 )*6 + col+2 ] == 0 ) )
-			{
-				if( col + 2 <= 5 && row + 2 <= 5 )
-				{
-					if( simulation_grid[ (row + 2) * 6 + col + 2 ] == 0 )
-						simulation_grid[ (row + 2) * 6 + col + 2 ] = simulation_grid[ (row + 1) * 6 + col + 1 ];
-				}
-				else // if a piece has been ejected out the board, we need to put it into the right pool
-				{
-					if( simulation_grid[ (row + 1) * 6 + col + 1 ] > 0 )
-					{
-						// in every case, either a Po or a Bo has been ejected out the board
-						red_pool[ red_pool_size ] = 1;
-
-						if( simulation_grid[ (row + 1) * 6 + col + 1 ] == 2 ) // if it is a Bo though
-						{
-							int i = 0;
-							while( red_pool[ i ] == 2 )
-								++i;
-							red_pool[ i ] = 2;
-						}
-
-						++red_pool_size;
-					}
-					else
-					{
-						blue_pool[ blue_pool_size ] = 1;
-
-						if( simulation_grid[ (row + 1) * 6 + col + 1 ] == -2 ) // if it is a Bo though
-						{
-							int i = 0;
-							while( blue_pool[ i ] == 2 )
-								++i;
-							blue_pool[ i ] = 2;
-						}
+		jbyte pushed = simulation_grid[ neighbours[i] ];
+		if( ( pushed & pushable ) == 0 )
+			continue;
 
-						++blue_pool_size;
-					}
-				}
-
-				simulation_grid[ (row + 1) * 6 + col + 1 ] = 0;
-			}
-		}
-
-		// Right
-		if( simulation_grid[ row*6 + col+1 ] != 0 &&
-		    std::abs( simulation_grid[ row*6 + col+1 ] ) <= std::abs( simulation_grid[ index ] ) &&
-		    ( col+2 > 5 || simulation_grid[ row*6 + col+2 ] == 0 ))
+		if( targets[i] == OFF_BOARD ) // if a piece has been ejected out the board, we need to put it into the right pool
+			( pushed < 0 ? blue_pool : red_pool ).add( std::abs( pushed ) );
+		else
 		{
-			if( col + 2 <= 5 )
-			{
-				if( simulation_grid[ row * 6 + col + 2 ] == 0 )
-					simulation_grid[ row * 6 + col + 2 ] = simulation_grid[ row * 6 + col + 1 ];
-			}
-			else // if a piece has been ejected out the board, we need to put it into the right pool
-			{
-				if( simulation_grid[ row * 6 + col + 1 ] > 0 )
-				{
-					// in every case, either a Po or a Bo has been ejected out the board
-					red_pool[ red_pool_size ] = 1;
+			if( simulation_grid[ targets[i] ] != 0 )
+				continue;
 
-					if( simulation_grid[ row * 6 + col + 1 ] == 2 ) // if it is a Bo though
-					{
-						int i = 0;
-						while( red_pool[ i ] == 2 )
-							++i;
-						red_pool[ i ] = 2;
-					}
-
-					++red_pool_size;
-				}
-				else
-				{
-					blue_pool[ blue_pool_size ] = 1;
-
-					if( simulation_grid[ row * 6 + col + 1 ] == -2 ) // if it is a Bo though
-					{
-						int i = 0;
-						while( blue_pool[ i ] == 2 )
-							++i;
-						blue_pool[ i ] = 2;
-					}
-
-					++blue_pool_size;
-				}
-			}
-
-			simulation_grid[ row * 6 + col + 1 ] = 0;
+			simulation_grid[ targets[i] ] = pushed;
+			if( hash )
+				*hash ^= zobrist_cell( targets[i], pushed );
 		}
-	}
-
-	// Top
-	if( row-1 >= 0 )
-	{
-		if( simulation_grid[ ( row-1 )*6 + col ] != 0 &&
-		    std::abs( simulation_grid[ ( row-1 )*6 + col ] ) <= std::abs( simulation_grid[ index ] ) &&
-		    ( row-2 < 0 || simulation_grid[ ( row-2 )*6 + col ] == 0 ))
-		{
-			if( row - 2 >= 0 )
-			{
-				if( simulation_grid[ (row - 2) * 6 + col ] == 0 )
-					simulation_grid[ (row - 2) * 6 + col ] = simulation_grid[ (row - 1) * 6 + col ];
-			}
-			else // if a piece has been ejected out the board, we need to put it into the right pool
-			{
-				if( simulation_grid[ (row - 1) * 6 + col ] > 0 )
-				{
-					// in every case, either a Po or a Bo has been ejected out the board
-					red_pool[ red_pool_size ] = 1;
-
-					if( simulation_grid[ (row - 1) * 6 + col ] == 2 ) // if it is a Bo though
-					{
-						int i = 0;
-						while( red_pool[ i ] == 2 )
-							++i;
-						red_pool[ i ] = 2;
-					}
-
-					++red_pool_size;
-				}
-				else
-				{
-					blue_pool[ blue_pool_size ] = 1;
-
-					if( simulation_grid[ (row - 1) * 6 + col ] == -2 ) // if it is a Bo though
-					{
-						int i = 0;
-						while( blue_pool[ i ] == 2 )
-							++i;
-						blue_pool[ i ] = 2;
-					}
-
-					++blue_pool_size;
-				}
-			}
 
-			simulation_grid[ (row - 1) * 6 + col ] = 0;
-		}
+		simulation_grid[ neighbours[i] ] = 0;
+		if( hash )
+			*hash ^= zobrist_cell( neighbours[i], pushed );
 	}
 
-	// Bottom
-	if( row+1 <= 5 )
-	{
-		if( simulation_grid[ ( row+1 )*6 + col ] != 0 &&
-		    std::abs( simulation_grid[ ( row+1 )*6 + col ] ) <= std::abs( simulation_grid[ index ] ) &&
-		    ( row+2 > 5 || simulation_grid[ ( row+2 )*6 + col ] == 0 ))
-		{
-			if( row + 2 <= 5 )
-			{
-				if( simulation_grid[ (row + 2) * 6 + col ] == 0 )
-					simulation_grid[ (row + 2) * 6 + col ] = simulation_grid[ (row + 1) * 6 + col ];
-			}
-			else // if a piece has been ejected out the board, we need to put it into the right pool
-			{
-				if( simulation_grid[ (row + 1) * 6 + col ] > 0 )
-				{
-					// in every case, either a Po or a Bo has been ejected out the board
-					red_pool[ red_pool_size ] = 1;
-
-					if( simulation_grid[ (row + 1) * 6 + col ] == 2 ) // if it is a Bo though
-					{
-						int i = 0;
-						while( red_pool[ i ] == 2 )
-							++i;
-						red_pool[ i ] = 2;
-					}
-
-					++red_pool_size;
-				}
-				else
-				{
-					blue_pool[ blue_pool_size ] = 1;
-
-					if( simulation_grid[ (row + 1) * 6 + col ] == -2 ) // if it is a Bo though
-					{
-						int i = 0;
-						while( blue_pool[ i ] == 2 )
-							++i;
-						blue_pool[ i ] = 2;
-					}
-
-					++blue_pool_size;
-				}
-			}
-
-			simulation_grid[ (row + 1) * 6 + col ] = 0;
-		}
-	}
+	if( hash )
+		*hash ^= zobrist_pools( blue_pool, red_pool );
+}
 
-	auto groups = get_promotions( simulation_grid, blue_turn, blue_pool_size, red_pool_size );
+void simulate_promotion( jbyte * const simulation_grid,
+                         jboolean blue_turn,
+                         Pool & blue_pool,
+                         Pool & red_pool,
+                         std::uint64_t * const hash )
+{
+	auto groups = get_promotions( simulation_grid, blue_turn, blue_pool.size(), red_pool.size() );
 	std::vector< Position > group_to_promote;
 
 	if( groups.size() > 0 )
@@ -463,7 +151,6 @@ void simulate_move( const std::vector<ghost::Variable *> &variables,
 			group_to_promote = groups[0];
 		else
 		{
-			randutils::mt19937_rng rng;
 			auto scores = heuristic_promotions( simulation_grid, groups );
 			double best_score = -10000.0;
 			std::vector<int> best_groups;
@@ -471,43 +158,45 @@ void simulate_move( const std::vector<ghost::Variable *> &variables,
 			for( int i = 0; i < groups.size(); ++i )
 			{
 				if(groups[i].size() == 1)
-					ALOG("Group[%d] {(%d,%d)} score = %.2f\n", i, groups[i][0].row, groups[i][0].column, scores[i]);
+					TRACE_SIMULATOR("Group[%d] {(%d,%d)} score = %.2f\n", i, groups[i][0].row, groups[i][0].column, scores[i]);
 				else
-					ALOG("Group[%d] {(%d,%d), (%d,%d), (%d,%d)} score = %.2f\n", i, groups[i][0].row, groups[i][0].column, groups[i][1].row, groups[i][1].column, groups[i][2].row, groups[i][2].column, scores[i]);
+					TRACE_SIMULATOR("Group[%d] {(%d,%d), (%d,%d), (%d,%d)} score = %.2f\n", i, groups[i][0].row, groups[i][0].column, groups[i][1].row, groups[i][1].column, groups[i][2].row, groups[i][2].column, scores[i]);
 
 				if( best_score < scores[ i ] )
 				{
 					best_score = scores[ i ];
 					best_groups.clear();
 					best_groups.push_back( i );
-					ALOG("Group[%d] is the new best group\n", i);
+					TRACE_SIMULATOR("Group[%d] is the new best group\n", i);
 				}
 				else
 					if( best_score == scores[ i ] )
 					{
 						best_groups.push_back( i );
-						ALOG("Group[%d] is ex aequo\n", i);
+						TRACE_SIMULATOR("Group[%d] is ex aequo\n", i);
 					}
 			}
 
-			auto picked_group = rng.pick( best_groups );
-			ALOG("Group[%d] has been selected\n", picked_group);
+			auto picked_group = thread_random().pick( best_groups );
+			TRACE_SIMULATOR("Group[%d] has been selected\n", picked_group);
 			group_to_promote = groups[ picked_group ];
 		}
 
+		if( hash )
+			*hash ^= zobrist_pools( blue_pool, red_pool );
+
+		// promoted pieces, Po or Bo, are back in the pool as Bo
 		for( auto pos : group_to_promote )
 		{
-			simulation_grid[ 6*pos.row + pos.column ] = 0;
-			if( blue_turn )
-			{
-				blue_pool[ blue_pool_size ] = 2;
-				++blue_pool_size;
-			}
-			else
-			{
-				red_pool[ red_pool_size ] = 2;
-				++red_pool_size;
-			}
+			int index = 6*pos.row + pos.column;
+			if( hash )
+				*hash ^= zobrist_cell( index, simulation_grid[ index ] );
+			simulation_grid[ index ] = 0;
 		}
+
+		( blue_turn ? blue_pool : red_pool ).add( 2, static_cast<int>( group_to_promote.size() ) );
+
+		if( hash )
+			*hash ^= zobrist_pools( blue_pool, red_pool );
 	}
 }
\ No newline at end of file
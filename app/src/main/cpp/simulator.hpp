@@ -7,17 +7,46 @@
 
 #include "helpers.hpp"
 #include "heuristics.hpp"
+#include "pool.hpp"
 
-#include <jni.h>
+#include "jni_types.hpp"
+#include <cstdint>
 #include <vector>
 #include "lib/include/ghost/variable.hpp"
 
 void simulate_move( const std::vector<ghost::Variable *> &variables,
                     jbyte * const simulation_grid,
                     jboolean blue_turn,
-                    jbyte * const blue_pool,
-                    jint & blue_pool_size,
-                    jbyte * const red_pool,
-                    jint & red_pool_size );
+                    Pool & blue_pool,
+                    Pool & red_pool );
+
+// If hash is given, the Zobrist hash of the position (see zobrist.hpp) is updated along the grid and pools
+void simulate_move( int piece,
+                    int row,
+                    int col,
+                    jbyte * const simulation_grid,
+                    jboolean blue_turn,
+                    Pool & blue_pool,
+                    Pool & red_pool,
+                    std::uint64_t * const hash = nullptr );
+
+// Place the piece and push its neighbours, without promoting any group.
+// Ejected pieces are put back into their player's pool.
+void simulate_push( int piece,
+                    int row,
+                    int col,
+                    jbyte * const simulation_grid,
+                    jboolean blue_turn,
+                    Pool & blue_pool,
+                    Pool & red_pool,
+                    std::uint64_t * const hash = nullptr );
+
+// Promote the group of the current player having the best heuristic_promotions score,
+// if any. Ties are broken randomly.
+void simulate_promotion( jbyte * const simulation_grid,
+                         jboolean blue_turn,
+                         Pool & blue_pool,
+                         Pool & red_pool,
+                         std::uint64_t * const hash = nullptr );
 
 #endif //POBO_SIMULATOR_HPP
@@ -0,0 +1,77 @@
+#include <algorithm>
+
+#include "symmetry.hpp"
+#include "heuristics.hpp"
+#include "transposition_table.hpp"
+#include "zobrist.hpp"
+
+int canonical_symmetry( const jbyte * const grid,
+                        const Pool &blue_pool,
+                        const Pool &red_pool,
+                        jboolean blue_turn,
+                        std::uint64_t &canonical_hash )
+{
+	// pools and player to move are the same for all twins: they are added to the smallest hash afterward
+	std::uint64_t hashes[ NUMBER_SYMMETRIES ] = {};
+	for( int index = 0 ; index < 36 ; ++index )
+	{
+		if( grid[ index ] == 0 )
+			continue;
+
+		for( int symmetry = 0 ; symmetry < NUMBER_SYMMETRIES ; ++symmetry )
+			hashes[ symmetry ] ^= zobrist_cell( symmetry_table.cell[ symmetry ][ index ], grid[ index ] );
+	}
+
+	int canonical = static_cast<int>( std::min_element( hashes, hashes + NUMBER_SYMMETRIES ) - hashes );
+
+	canonical_hash = hashes[ canonical ] ^ zobrist_pools( blue_pool, red_pool );
+	if( blue_turn )
+		canonical_hash ^= zobrist_keys.blue_turn;
+
+	return canonical;
+}
+
+void transform_grid( const jbyte * const grid, int symmetry, jbyte * const transformed_grid )
+{
+	for( int index = 0 ; index < 36 ; ++index )
+		transformed_grid[ symmetry_table.cell[ symmetry ][ index ] ] = grid[ index ];
+}
+
+int stabiliser_symmetries( const jbyte * const grid, int * const symmetries )
+{
+	int number_symmetries = 0;
+	for( int symmetry = 1 ; symmetry < NUMBER_SYMMETRIES ; ++symmetry )
+	{
+		bool is_invariant = true;
+		for( int index = 0 ; index < 36 && is_invariant ; ++index )
+			is_invariant = grid[ symmetry_table.cell[ symmetry ][ index ] ] == grid[ index ];
+
+		if( is_invariant )
+			symmetries[ number_symmetries++ ] = symmetry;
+	}
+
+	return number_symmetries;
+}
+
+double symmetric_heuristic_state( const jbyte * const simulation_grid,
+                                  jboolean blue_turn,
+                                  const Pool &blue_pool,
+                                  const Pool &red_pool )
+{
+	// the canonical hash is the Zobrist hash of the canonical orientation: its entry is the same
+	// as the one of an exact evaluation of that orientation
+	std::uint64_t hash;
+	int symmetry = canonical_symmetry( simulation_grid, blue_pool, red_pool, blue_turn, hash );
+
+	TranspositionTable &table = evaluation_table();
+	TranspositionEntry entry;
+	if( table.probe( hash, entry ) )
+		return entry.score;
+
+	jbyte canonical_grid[36];
+	transform_grid( simulation_grid, symmetry, canonical_grid );
+
+	double score = HeuristicEvaluator( canonical_grid, blue_turn, blue_pool, red_pool ).score();
+	table.store( hash, score, 0, Bound::EXACT );
+	return score;
+}
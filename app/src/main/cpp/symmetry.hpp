@@ -0,0 +1,64 @@
+#ifndef POBO_SYMMETRY_HPP
+#define POBO_SYMMETRY_HPP
+
+#include <cstdint>
+#include "jni_types.hpp"
+#include "pool.hpp"
+
+// heuristic_state is not exactly invariant under rotations and reflections of the board: lines are scanned
+// in one direction only, and diagonal scans carry skipped cells over to the next diagonal. About 1% of
+// positions score differently once rotated.
+// Define POBO_SYMMETRIC_EVALUATION to score every position as its canonical orientation instead:
+// the 8 symmetric twins of a position then share a single evaluation table entry.
+#ifndef POBO_SYMMETRIC_EVALUATION
+#define POBO_SYMMETRIC_EVALUATION 0
+#endif
+
+// The 8 symmetries of the square (dihedral group D4): identity, rotations by 90, 180 and 270 degrees,
+// then reflections through the vertical axis, the horizontal axis, the main diagonal and the anti-diagonal
+constexpr int NUMBER_SYMMETRIES = 8;
+
+struct SymmetryTable
+{
+	jbyte cell[ NUMBER_SYMMETRIES ][36]; // where each cell goes
+};
+
+constexpr SymmetryTable make_symmetry_table()
+{
+	SymmetryTable table{};
+	for( int row = 0 ; row < 6 ; ++row )
+		for( int col = 0 ; col < 6 ; ++col )
+		{
+			const int rows[ NUMBER_SYMMETRIES ] = { row, col, 5 - row, 5 - col, row, 5 - row, col, 5 - col };
+			const int cols[ NUMBER_SYMMETRIES ] = { col, 5 - row, 5 - col, row, 5 - col, col, row, 5 - row };
+			for( int symmetry = 0 ; symmetry < NUMBER_SYMMETRIES ; ++symmetry )
+				table.cell[ symmetry ][ row * 6 + col ] = static_cast<jbyte>( rows[ symmetry ] * 6 + cols[ symmetry ] );
+		}
+
+	return table;
+}
+
+inline constexpr SymmetryTable symmetry_table = make_symmetry_table();
+
+// The canonical orientation of a position is its symmetric twin with the smallest Zobrist hash.
+// Return the symmetry leading to it, and its hash in canonical_hash.
+int canonical_symmetry( const jbyte * const grid,
+                        const Pool &blue_pool,
+                        const Pool &red_pool,
+                        jboolean blue_turn,
+                        std::uint64_t &canonical_hash );
+
+void transform_grid( const jbyte * const grid, int symmetry, jbyte * const transformed_grid );
+
+// Symmetries other than the identity leaving the grid unchanged, written into symmetries
+// (which must hold NUMBER_SYMMETRIES values). Return their number.
+int stabiliser_symmetries( const jbyte * const grid, int * const symmetries );
+
+// heuristic_state of the canonical orientation of the position, computed once per thread for all
+// symmetric twins thanks to the evaluation table (see transposition_table.hpp)
+double symmetric_heuristic_state( const jbyte * const simulation_grid,
+                                  jboolean blue_turn,
+                                  const Pool &blue_pool,
+                                  const Pool &red_pool );
+
+#endif //POBO_SYMMETRY_HPP
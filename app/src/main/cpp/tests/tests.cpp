@@ -0,0 +1,501 @@
+// Host tests of the engine core: the simulator and get_promotions against the baseline rules, incremental
+// Zobrist hashes and heuristic evaluations against full recomputations, the move generators against a brute
+// force scoring of all legal moves, and TopK, symmetries, the transposition table and alpha-beta.
+// Positions come from random games played from fixed seeds.
+// Usage: pobo_tests [number_positions]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "alpha_beta.hpp"
+#include "game.hpp"
+#include "helpers.hpp"
+#include "heuristics.hpp"
+#include "move_generator.hpp"
+#include "simulator.hpp"
+#include "symmetry.hpp"
+#include "top_k.hpp"
+#include "transposition_table.hpp"
+#include "zobrist.hpp"
+
+static int number_failures = 0;
+
+#define CHECK( condition ) \
+	do \
+	{ \
+		if( !( condition ) ) \
+		{ \
+			++number_failures; \
+			std::printf( "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition ); \
+		} \
+	} while( false )
+
+// Scores are sums of partial scores that may be added in another order
+static bool is_close( double a, double b )
+{
+	return std::abs( a - b ) <= 1e-9 * std::max( 1.0, std::abs( a ) );
+}
+
+static bool same_grid( const jbyte * const a, const jbyte * const b )
+{
+	return std::equal( a, a + 36, b );
+}
+
+static bool same_pool( const Pool &a, const Pool &b )
+{
+	return a.po == b.po && a.bo == b.bo;
+}
+
+static bool same_groups( const std::vector< std::vector<Position> > &a, const std::vector< std::vector<Position> > &b )
+{
+	return std::equal( a.begin(), a.end(), b.begin(), b.end(), []( auto &group_a, auto &group_b )
+	{
+		return std::equal( group_a.begin(), group_a.end(), group_b.begin(), group_b.end(), []( auto &position_a, auto &position_b )
+		{
+			return position_a.row == position_b.row && position_a.column == position_b.column;
+		} );
+	} );
+}
+
+// Positions before each move of random games, always from the same seed.
+// Each play_move also checks that the hash it keeps up to date is the hash of the reached position.
+static std::vector<State> make_positions( int number_positions, std::uint64_t seed )
+{
+	Random rng( seed );
+	std::vector<State> positions;
+	std::vector<Move> no_moves_to_remove;
+
+	while( static_cast<int>( positions.size() ) < number_positions )
+	{
+		jbyte grid[36] = { 0 };
+		State state = make_state( grid, Pool{ 8, 0 }, Pool{ 8, 0 }, false, 0 );
+
+		int winner = 0;
+		Move move;
+		while( winner == 0 && static_cast<int>( positions.size() ) < number_positions
+		       && random_move( state, no_moves_to_remove, rng, move ) )
+		{
+			positions.push_back( state );
+			winner = play_move( state, move );
+			CHECK( state.hash == zobrist_hash( state.grid, state.blue_pool, state.red_pool, state.blue_turn ) );
+		}
+	}
+
+	return positions;
+}
+
+// Baseline simulate_move up to promotions: the placed piece pushes each neighbour at most as big as itself
+// one cell further in the same direction, if this cell is empty. Pieces pushed off the board go back
+// into their player's pool.
+static void reference_push( int piece,
+                            int row,
+                            int col,
+                            jbyte * const grid,
+                            jboolean blue_turn,
+                            Pool &blue_pool,
+                            Pool &red_pool )
+{
+	( blue_turn ? blue_pool : red_pool ).remove( piece );
+
+	jbyte placed = static_cast<jbyte>( piece * ( blue_turn ? -1 : 1 ) );
+	grid[ row * 6 + col ] = placed;
+
+	for( int delta_row = -1 ; delta_row <= 1 ; ++delta_row )
+		for( int delta_col = -1 ; delta_col <= 1 ; ++delta_col )
+		{
+			int next_row = row + delta_row;
+			int next_col = col + delta_col;
+			if( ( delta_row == 0 && delta_col == 0 ) || !is_valid_position( next_row, next_col ) )
+				continue;
+
+			jbyte &neighbour = grid[ next_row * 6 + next_col ];
+			if( neighbour == 0 || std::abs( neighbour ) > std::abs( placed ) )
+				continue;
+
+			int target_row = next_row + delta_row;
+			int target_col = next_col + delta_col;
+			if( is_valid_position( target_row, target_col ) )
+			{
+				if( grid[ target_row * 6 + target_col ] != 0 )
+					continue;
+				grid[ target_row * 6 + target_col ] = neighbour;
+			}
+			else
+				( neighbour > 0 ? red_pool : blue_pool ).add( std::abs( neighbour ) );
+
+			neighbour = 0;
+		}
+}
+
+// Baseline get_promotions: cell by cell, each piece of the player alone if their pool is empty,
+// then each group of 3 aligned pieces of the player starting there, except 3 Bo
+static std::vector< std::vector<Position> > reference_promotions( jbyte * const grid,
+                                                                  jboolean blue_turn,
+                                                                  int blue_pool_size,
+                                                                  int red_pool_size )
+{
+	auto is_own_piece = [&]( const Position &position )
+	{
+		return is_valid_position( position )
+		       && !is_empty_position( grid, position )
+		       && !is_blue_piece_on( grid, position ) == !blue_turn;
+	};
+
+	std::vector< std::vector<Position> > promotions;
+	for( int row = 0 ; row < 6 ; ++row )
+		for( int col = 0 ; col < 6 ; ++col )
+		{
+			Position position( row, col );
+			if( !is_own_piece( position ) )
+				continue;
+
+			if( ( blue_turn ? blue_pool_size : red_pool_size ) == 0 )
+				promotions.emplace_back( std::vector<Position>{ position } );
+
+			for( int dir = Direction::TOPRIGHT; dir <= Direction::BOTTOM; ++dir )
+			{
+				Position next = get_position_toward( position, dir );
+				Position next_next = get_position_toward( next, dir );
+
+				if( is_own_piece( next ) && is_own_piece( next_next )
+				    && !( std::abs( grid[ 6 * row + col ] ) == 2
+				          && std::abs( grid[ 6 * next.row + next.column ] ) == 2
+				          && std::abs( grid[ 6 * next_next.row + next_next.column ] ) == 2 ) )
+					promotions.emplace_back( std::vector<Position>{ position, next, next_next } );
+			}
+		}
+
+	return promotions;
+}
+
+// simulate_push and get_promotions give the same grid, pools and groups as the baseline for every legal move,
+// and the hash updated by simulate_move is the hash of the reached position
+static void test_simulator( const std::vector<State> &positions )
+{
+	for( auto &state : positions )
+		for( auto &move : legal_moves( state ) )
+		{
+			jbyte grid[36];
+			std::copy( state.grid, state.grid + 36, grid );
+			Pool blue_pool = state.blue_pool;
+			Pool red_pool = state.red_pool;
+			simulate_push( move.piece, move.row, move.col, grid, state.blue_turn, blue_pool, red_pool );
+
+			jbyte expected_grid[36];
+			std::copy( state.grid, state.grid + 36, expected_grid );
+			Pool expected_blue_pool = state.blue_pool;
+			Pool expected_red_pool = state.red_pool;
+			reference_push( move.piece, move.row, move.col, expected_grid, state.blue_turn, expected_blue_pool, expected_red_pool );
+
+			CHECK( same_grid( grid, expected_grid ) );
+			CHECK( same_pool( blue_pool, expected_blue_pool ) );
+			CHECK( same_pool( red_pool, expected_red_pool ) );
+
+			for( jboolean blue_turn : { false, true } )
+				CHECK( same_groups( get_promotions( grid, blue_turn, blue_pool.size(), red_pool.size() ),
+				                    reference_promotions( grid, blue_turn, blue_pool.size(), red_pool.size() ) ) );
+
+			std::copy( state.grid, state.grid + 36, grid );
+			blue_pool = state.blue_pool;
+			red_pool = state.red_pool;
+			std::uint64_t hash = state.hash;
+			simulate_move( move.piece, move.row, move.col, grid, state.blue_turn, blue_pool, red_pool, &hash );
+			CHECK( hash == zobrist_hash( grid, blue_pool, red_pool, state.blue_turn ) );
+		}
+}
+
+// HeuristicEvaluator updated along a game scores like heuristic_state computed from scratch
+static void test_evaluator( const std::vector<State> &positions )
+{
+	for( jboolean perspective_is_blue : { false, true } )
+	{
+		HeuristicEvaluator evaluator( positions[0].grid, perspective_is_blue, positions[0].blue_pool, positions[0].red_pool );
+
+		for( auto &state : positions )
+		{
+			jbyte grid[36];
+			std::copy( state.grid, state.grid + 36, grid );
+
+			evaluator.update( state.grid, state.blue_pool, state.red_pool );
+			CHECK( is_close( evaluator.score(), heuristic_state( grid, perspective_is_blue, state.blue_pool, state.red_pool ) ) );
+		}
+	}
+}
+
+// True if playing any legal move promotes at most one group: score_move and play_move are then deterministic
+static bool has_deterministic_moves( const State &state )
+{
+	for( auto &move : legal_moves( state ) )
+	{
+		jbyte grid[36];
+		std::copy( state.grid, state.grid + 36, grid );
+		Pool blue_pool = state.blue_pool;
+		Pool red_pool = state.red_pool;
+		simulate_push( move.piece, move.row, move.col, grid, state.blue_turn, blue_pool, red_pool );
+
+		if( get_promotions( grid, state.blue_turn, blue_pool.size(), red_pool.size() ).size() > 1 )
+			return false;
+	}
+
+	return true;
+}
+
+// The number_best best moves not in moves_to_remove plus the moves tied with the last of them,
+// from score_move of every legal move, in legal_moves order
+static void brute_force_best_moves( const State &state,
+                                    const std::vector<Move> &moves_to_remove,
+                                    int number_best,
+                                    std::vector<double> &costs,
+                                    std::vector<Move> &moves )
+{
+	std::vector<double> all_costs;
+	std::vector<Move> all_moves;
+	for( auto &move : legal_moves( state ) )
+		if( std::find( moves_to_remove.begin(), moves_to_remove.end(), move ) == moves_to_remove.end() )
+		{
+			all_costs.push_back( score_move( state, move ) );
+			all_moves.push_back( move );
+		}
+
+	std::vector<double> sorted_costs = all_costs;
+	std::sort( sorted_costs.begin(), sorted_costs.end(), std::greater<double>() );
+	double threshold = sorted_costs.empty() ? 0.0 : sorted_costs[ std::min( number_best, static_cast<int>( sorted_costs.size() ) ) - 1 ];
+
+	costs.clear();
+	moves.clear();
+	for( int i = 0 ; i < static_cast<int>( all_moves.size() ) ; ++i )
+		if( all_costs[i] >= threshold || is_close( all_costs[i], threshold ) )
+		{
+			costs.push_back( all_costs[i] );
+			moves.push_back( all_moves[i] );
+		}
+}
+
+static bool same_best_moves( const std::vector<double> &costs,
+                             const std::vector<Move> &moves,
+                             const std::vector<double> &expected_costs,
+                             const std::vector<Move> &expected_moves )
+{
+	return moves == expected_moves
+	       && std::equal( costs.begin(), costs.end(), expected_costs.begin(), expected_costs.end(), is_close );
+}
+
+using BestMoves = std::function<bool( const State &, const std::vector<Move> &, int, std::vector<double> &, std::vector<Move> & )>;
+
+// best_moves against brute_force_best_moves for several number_best, with and without moves to remove
+static void check_best_moves( const std::vector<State> &positions, const BestMoves &best_moves )
+{
+	Random rng( 7u );
+
+	for( auto &state : positions )
+	{
+		if( !has_deterministic_moves( state ) )
+			continue;
+
+		std::vector<Move> legal = legal_moves( state );
+		std::vector<Move> moves_to_remove;
+		for( int i = 0 ; i < 3 && !legal.empty() ; ++i )
+			moves_to_remove.push_back( rng.pick( legal ) );
+
+		for( auto &removed : { std::vector<Move>(), moves_to_remove } )
+			for( int number_best : { 1, 2, 5, NUMBER_MOVE_SLOTS } )
+			{
+				std::vector<double> costs, expected_costs;
+				std::vector<Move> moves, expected_moves;
+				bool found = best_moves( state, removed, number_best, costs, moves );
+				brute_force_best_moves( state, removed, number_best, expected_costs, expected_moves );
+
+				CHECK( found == !expected_moves.empty() );
+				CHECK( same_best_moves( costs, moves, expected_costs, expected_moves ) );
+			}
+	}
+}
+
+static void test_native_best_moves( const std::vector<State> &positions )
+{
+	check_best_moves( positions, native_best_moves );
+}
+
+#ifndef POBO_WITHOUT_GHOST
+// ghost::Solver::complete_optimization, through ghost_best_moves, against brute force,
+// and ghost::Solver::complete_search against the native enumeration
+static void test_ghost_solver( const std::vector<State> &positions )
+{
+	check_best_moves( positions, ghost_best_moves );
+
+	std::vector<Move> no_moves_to_remove;
+	for( auto &state : positions )
+	{
+		if( !has_deterministic_moves( state ) )
+			continue;
+
+		std::vector<double> costs, expected_costs;
+		std::vector< std::vector<int> > solutions, expected_solutions;
+		bool found = ghost_complete_search( state, no_moves_to_remove, costs, solutions );
+		bool expected_found = native_complete_search( state, no_moves_to_remove, expected_costs, expected_solutions );
+
+		CHECK( found == expected_found );
+		CHECK( solutions == expected_solutions );
+		CHECK( std::equal( costs.begin(), costs.end(), expected_costs.begin(), expected_costs.end(), is_close ) );
+	}
+}
+#endif
+
+// TopK keeps the k highest costs among many tied ones
+static void test_top_k()
+{
+	Random rng( 11u );
+
+	for( int round = 0 ; round < 1000 ; ++round )
+	{
+		int k = rng.uniform( 0, 20 );
+		std::vector<double> costs( rng.uniform( 0, 40 ) );
+		for( auto &cost : costs )
+			cost = rng.uniform( 0, 9 );
+
+		TopK<double> selector( k, rng );
+		for( double cost : costs )
+			selector.add( cost, cost );
+
+		std::sort( costs.begin(), costs.end(), std::greater<double>() );
+		costs.resize( std::min( k, static_cast<int>( costs.size() ) ) );
+
+		CHECK( selector.items() == costs );
+	}
+}
+
+// Symmetric twins share their canonical hash, and stabiliser_symmetries finds exactly the symmetries leaving the grid unchanged
+static void test_symmetries( const std::vector<State> &positions )
+{
+	for( auto &state : positions )
+	{
+		std::uint64_t canonical_hash;
+		canonical_symmetry( state.grid, state.blue_pool, state.red_pool, state.blue_turn, canonical_hash );
+
+		int symmetries[ NUMBER_SYMMETRIES ];
+		int number_symmetries = stabiliser_symmetries( state.grid, symmetries );
+		int expected_number_symmetries = 0;
+
+		for( int symmetry = 0 ; symmetry < NUMBER_SYMMETRIES ; ++symmetry )
+		{
+			jbyte twin[36];
+			transform_grid( state.grid, symmetry, twin );
+
+			std::uint64_t twin_canonical_hash;
+			int twin_symmetry = canonical_symmetry( twin, state.blue_pool, state.red_pool, state.blue_turn, twin_canonical_hash );
+			CHECK( twin_canonical_hash == canonical_hash );
+
+			jbyte canonical_grid[36];
+			transform_grid( twin, twin_symmetry, canonical_grid );
+			CHECK( zobrist_hash( canonical_grid, state.blue_pool, state.red_pool, state.blue_turn ) == canonical_hash );
+
+			if( symmetry > 0 && same_grid( twin, state.grid ) )
+			{
+				CHECK( std::find( symmetries, symmetries + number_symmetries, symmetry ) != symmetries + number_symmetries );
+				++expected_number_symmetries;
+			}
+		}
+
+		CHECK( number_symmetries == expected_number_symmetries );
+	}
+
+	// a grid symmetric through both diagonals
+	jbyte grid[36] = { 0 };
+	grid[0] = grid[35] = 2;
+	grid[14] = grid[21] = -1;
+	int symmetries[ NUMBER_SYMMETRIES ];
+	CHECK( stabiliser_symmetries( grid, symmetries ) == 3 );
+}
+
+// Stored entries are found again with their content, other hashes are not found
+static void test_transposition_table()
+{
+	Random rng( 13u );
+	TranspositionTable table( 10 );
+
+	for( int round = 0 ; round < 1000 ; ++round )
+	{
+		std::uint64_t hash = rng();
+		double score = rng.uniform( -1000, 1000 ) / 8.0;
+		int depth = rng.uniform( 0, 10 );
+		int slot = rng.uniform( -1, NUMBER_MOVE_SLOTS - 1 );
+		table.store( hash, score, depth, Bound::LOWER, slot );
+
+		TranspositionEntry entry;
+		CHECK( table.probe( hash, entry ) );
+		CHECK( entry.score == score && entry.depth == depth && entry.bound == Bound::LOWER && entry.move_slot == slot );
+		CHECK( !table.probe( rng(), entry ) );
+	}
+
+	table.clear();
+	TranspositionEntry entry;
+	CHECK( !table.probe( rng(), entry ) );
+}
+
+// A 1-ply alpha-beta search finds the best score_move, when no move wins or loses
+static void test_alpha_beta( const std::vector<State> &positions )
+{
+	AlphaBeta alpha_beta;
+
+	for( auto &state : positions )
+	{
+		if( !has_deterministic_moves( state ) )
+			continue;
+
+		std::vector<Move> moves = legal_moves( state );
+		double best_score = std::numeric_limits<double>::lowest();
+		bool has_winner = false;
+		for( auto &move : moves )
+		{
+			State next = state;
+			has_winner = has_winner || play_move( next, move ) != 0;
+			best_score = std::max( best_score, score_move( state, move ) );
+		}
+
+		if( moves.empty() || has_winner )
+			continue;
+
+		SearchResult result = alpha_beta.search( state, 100000, 1 );
+		CHECK( result.depth == 1 );
+		CHECK( is_close( result.score, best_score ) );
+		CHECK( !result.principal_variation.empty() && is_close( score_move( state, result.principal_variation[0] ), best_score ) );
+	}
+}
+
+static void run( const char *name, const std::function<void()> &test )
+{
+	int previous_failures = number_failures;
+	test();
+	std::printf( "%-24s %s\n", name, number_failures == previous_failures ? "ok" : "FAILED" );
+}
+
+int main( int argc, char **argv )
+{
+	int number_positions = argc > 1 ? std::atoi( argv[1] ) : 1000;
+	if( number_positions <= 0 )
+	{
+		std::fprintf( stderr, "usage: %s [number_positions]\n", argv[0] );
+		return EXIT_FAILURE;
+	}
+
+	seed_random( 42u );
+	std::vector<State> positions;
+	run( "play_move hash", [&]{ positions = make_positions( number_positions, 42u ); } );
+	run( "simulator", [&]{ test_simulator( positions ); } );
+	run( "heuristic evaluator", [&]{ test_evaluator( positions ); } );
+	run( "native best moves", [&]{ test_native_best_moves( positions ); } );
+#ifndef POBO_WITHOUT_GHOST
+	run( "ghost solver", [&]{ test_ghost_solver( positions ); } );
+#endif
+	run( "top k", test_top_k );
+	run( "symmetries", [&]{ test_symmetries( positions ); } );
+	run( "transposition table", test_transposition_table );
+	run( "alpha-beta", [&]{ test_alpha_beta( positions ); } );
+
+	return number_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
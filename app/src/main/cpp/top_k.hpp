@@ -0,0 +1,83 @@
+#ifndef POBO_TOP_K_HPP
+#define POBO_TOP_K_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "random.hpp"
+
+// Keep the k items with the highest costs among the ones given to add, in a single pass.
+// Kept items are in a min-heap of size k, ordered by cost then by a random key drawn for each item:
+// among items tied with the k-th best cost, the kept ones are a uniformly random subset, like with
+// reservoir sampling, whatever the order items come in.
+template<typename Item>
+class TopK
+{
+	struct Entry
+	{
+		double cost;
+		std::uint32_t random_key;
+		Item item;
+	};
+
+	// true if a is better than b: used as heap comparator, so that the heap front is the worst kept entry
+	static bool is_better( const Entry &a, const Entry &b )
+	{
+		return a.cost > b.cost || ( a.cost == b.cost && a.random_key > b.random_key );
+	}
+
+	int _k;
+	Random &_rng;
+	std::vector<Entry> _heap;
+
+public:
+	TopK( int k, Random &rng )
+		: _k( std::max( k, 0 ) ),
+		  _rng( rng )
+	{
+		_heap.reserve( _k );
+	}
+
+	void add( double cost, const Item &item )
+	{
+		if( _k == 0 )
+			return;
+
+		bool is_full = static_cast<int>( _heap.size() ) == _k;
+		// no need to draw a key for items that cannot be kept
+		if( is_full && cost < _heap.front().cost )
+			return;
+
+		Entry entry{ cost, static_cast<std::uint32_t>( _rng() >> 32 ), item };
+		if( !is_full )
+		{
+			_heap.push_back( entry );
+			std::push_heap( _heap.begin(), _heap.end(), is_better );
+		}
+		else
+			if( is_better( entry, _heap.front() ) )
+			{
+				std::pop_heap( _heap.begin(), _heap.end(), is_better );
+				_heap.back() = entry;
+				std::push_heap( _heap.begin(), _heap.end(), is_better );
+			}
+	}
+
+	int size() const { return static_cast<int>( _heap.size() ); }
+
+	// Kept items, best first. The selector is empty afterwards.
+	std::vector<Item> items()
+	{
+		std::sort_heap( _heap.begin(), _heap.end(), is_better );
+		std::vector<Item> items;
+		items.reserve( _heap.size() );
+		for( auto &entry : _heap )
+			items.push_back( entry.item );
+
+		_heap.clear();
+		return items;
+	}
+};
+
+#endif //POBO_TOP_K_HPP
@@ -0,0 +1,82 @@
+#ifndef POBO_TRACE_HPP
+#define POBO_TRACE_HPP
+
+// Compile-time traces of the native engine, one switch per subsystem:
+// POBO_TRACE_SIMULATOR (pushes and promotions), POBO_TRACE_HEURISTIC (state and promotion scores)
+// and POBO_TRACE_SOLVER (objective evaluations and solver outputs).
+// A disabled trace expands to nothing: its arguments are not even evaluated.
+
+#ifndef POBO_TRACE_SIMULATOR
+#define POBO_TRACE_SIMULATOR 0
+#endif
+
+#ifndef POBO_TRACE_HEURISTIC
+#define POBO_TRACE_HEURISTIC 0
+#endif
+
+#ifndef POBO_TRACE_SOLVER
+#define POBO_TRACE_SOLVER 0
+#endif
+
+#define POBO_NO_TRACE do { } while( false )
+
+#if POBO_TRACE_SIMULATOR || POBO_TRACE_HEURISTIC || POBO_TRACE_SOLVER
+
+#include "jni_types.hpp"
+#include "pool.hpp"
+
+#ifdef __ANDROID__
+// From https://manski.net/2012/05/logging-from-c-on-android/
+#include <android/log.h>
+#define POBO_LOG( ... ) __android_log_print( ANDROID_LOG_INFO, "pobotag C++", __VA_ARGS__ )
+#else
+#include <cstdio>
+#define POBO_LOG( ... ) ( std::fprintf( stderr, __VA_ARGS__ ), std::fputc( '\n', stderr ) )
+#endif
+
+// Board as 6 lines of 6 digits, Blue Po and Bo being printed as 9 and 8
+inline void trace_grid( const char *title, const jbyte * const grid, const Pool &blue_pool, const Pool &red_pool )
+{
+	char board[ 6 * 13 + 1 ];
+	int length = 0;
+	for( int i = 0 ; i < 36 ; ++i )
+	{
+		int p = grid[i] < 0 ? grid[i] + 10 : grid[i];
+		board[ length++ ] = static_cast<char>( '0' + p );
+		board[ length++ ] = ' ';
+		if( ( i + 1 ) % 6 == 0 )
+			board[ length++ ] = '\n';
+	}
+	board[ length ] = '\0';
+
+	POBO_LOG( "%s\n%sBlue pool = %d Po, %d Bo\nRed pool = %d Po, %d Bo\n",
+	          title, board, blue_pool.po, blue_pool.bo, red_pool.po, red_pool.bo );
+}
+
+#endif
+
+#if POBO_TRACE_SIMULATOR
+#define TRACE_SIMULATOR( ... ) POBO_LOG( __VA_ARGS__ )
+#define TRACE_SIMULATOR_GRID( title, grid, blue_pool, red_pool ) trace_grid( title, grid, blue_pool, red_pool )
+#else
+#define TRACE_SIMULATOR( ... ) POBO_NO_TRACE
+#define TRACE_SIMULATOR_GRID( title, grid, blue_pool, red_pool ) POBO_NO_TRACE
+#endif
+
+#if POBO_TRACE_HEURISTIC
+#define TRACE_HEURISTIC( ... ) POBO_LOG( __VA_ARGS__ )
+#define TRACE_HEURISTIC_GRID( title, grid, blue_pool, red_pool ) trace_grid( title, grid, blue_pool, red_pool )
+#else
+#define TRACE_HEURISTIC( ... ) POBO_NO_TRACE
+#define TRACE_HEURISTIC_GRID( title, grid, blue_pool, red_pool ) POBO_NO_TRACE
+#endif
+
+#if POBO_TRACE_SOLVER
+#define TRACE_SOLVER( ... ) POBO_LOG( __VA_ARGS__ )
+#define TRACE_SOLVER_GRID( title, grid, blue_pool, red_pool ) trace_grid( title, grid, blue_pool, red_pool )
+#else
+#define TRACE_SOLVER( ... ) POBO_NO_TRACE
+#define TRACE_SOLVER_GRID( title, grid, blue_pool, red_pool ) POBO_NO_TRACE
+#endif
+
+#endif //POBO_TRACE_HPP
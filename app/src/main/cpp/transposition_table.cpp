@@ -0,0 +1,63 @@
+#include <algorithm>
+
+#include "transposition_table.hpp"
+
+TranspositionTable::TranspositionTable( int log2_number_buckets )
+	: _buckets( new Bucket[ std::size_t( 1 ) << log2_number_buckets ] ),
+	  _mask( ( std::uint64_t( 1 ) << log2_number_buckets ) - 1 )
+{
+	clear();
+}
+
+bool TranspositionTable::probe( std::uint64_t hash, TranspositionEntry &entry ) const
+{
+	const Bucket &bucket = _buckets[ hash & _mask ];
+	std::uint32_t check = static_cast<std::uint32_t>( hash >> 32 );
+
+	for( auto &candidate : bucket.entries )
+		if( candidate.check == check && candidate.bound != Bound::NONE )
+		{
+			entry = candidate;
+			return true;
+		}
+
+	return false;
+}
+
+void TranspositionTable::store( std::uint64_t hash, double score, int depth, Bound bound, int move_slot )
+{
+	Bucket &bucket = _buckets[ hash & _mask ];
+	std::uint32_t check = static_cast<std::uint32_t>( hash >> 32 );
+
+	// same position first, then an empty entry, then the shallowest one
+	TranspositionEntry *replaced = &bucket.entries[0];
+	for( auto &candidate : bucket.entries )
+	{
+		if( candidate.check == check && candidate.bound != Bound::NONE )
+		{
+			replaced = &candidate;
+			break;
+		}
+
+		if( replaced->bound != Bound::NONE
+		    && ( candidate.bound == Bound::NONE || candidate.depth < replaced->depth ) )
+			replaced = &candidate;
+	}
+
+	replaced->check = check;
+	replaced->move_slot = static_cast<jbyte>( move_slot );
+	replaced->depth = static_cast<jbyte>( depth );
+	replaced->bound = bound;
+	replaced->score = score;
+}
+
+void TranspositionTable::clear()
+{
+	std::fill( _buckets.get(), _buckets.get() + _mask + 1, Bucket{} );
+}
+
+TranspositionTable &evaluation_table()
+{
+	static thread_local TranspositionTable table;
+	return table;
+}
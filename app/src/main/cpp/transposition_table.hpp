@@ -0,0 +1,61 @@
+#ifndef POBO_TRANSPOSITION_TABLE_HPP
+#define POBO_TRANSPOSITION_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "jni_types.hpp"
+
+// What a stored score is: the exact score of the position (static evaluations are exact),
+// or a lower or upper bound of it, for searches with alpha-beta cuts.
+enum class Bound : jbyte
+{
+	NONE, // empty entry
+	EXACT,
+	LOWER,
+	UPPER
+};
+
+// 16 bytes: 4 entries fit in a cache line
+struct TranspositionEntry
+{
+	std::uint32_t check; // upper half of the hash, the lower half being the bucket index
+	jbyte move_slot; // best move (see move_slot in move_generator.hpp), or -1
+	jbyte depth; // search depth the score comes from, 0 for a static evaluation
+	Bound bound;
+	jbyte padding;
+	double score;
+};
+
+static_assert( sizeof( TranspositionEntry ) == 16, "4 entries per 64-byte bucket" );
+
+// Fixed-size hash table of scores and best moves, indexed by Zobrist hashes (see zobrist.hpp).
+// Positions sharing a bucket compete for its 4 entries: the shallowest one is replaced.
+class TranspositionTable
+{
+	struct alignas( 64 ) Bucket
+	{
+		TranspositionEntry entries[4];
+	};
+
+	std::unique_ptr<Bucket[]> _buckets;
+	std::uint64_t _mask;
+
+public:
+	// 2^log2_number_buckets buckets of 64 bytes, i.e., 1MB by default
+	explicit TranspositionTable( int log2_number_buckets = 14 );
+
+	// Return true and fill entry if the position is in the table
+	bool probe( std::uint64_t hash, TranspositionEntry &entry ) const;
+
+	void store( std::uint64_t hash, double score, int depth, Bound bound, int move_slot = -1 );
+
+	void clear();
+};
+
+// Static evaluations of the calling thread, shared by the move generator and MCTS playouts.
+// heuristic_state scores are stored with depth 0, hashed with the scoring player as player to move
+// (see zobrist_perspective).
+TranspositionTable &evaluation_table();
+
+#endif //POBO_TRANSPOSITION_TABLE_HPP
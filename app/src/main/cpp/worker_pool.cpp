@@ -0,0 +1,68 @@
+#include "worker_pool.hpp"
+
+WorkerPool::WorkerPool()
+	: _run_id( 0 ),
+	  _number_workers( 0 ),
+	  _running_workers( 0 ),
+	  _stopping( false )
+{ }
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock( _run_lock );
+		_stopping = true;
+	}
+	_run_ready.notify_all();
+
+	for( auto &worker : _workers )
+		worker.join();
+}
+
+void WorkerPool::run_worker( int worker, std::uint64_t seed )
+{
+	Random rng( seed );
+	std::uint64_t last_run = 0;
+
+	std::unique_lock<std::mutex> lock( _run_lock );
+	while( true )
+	{
+		_run_ready.wait( lock, [&]() { return _stopping || _run_id != last_run; } );
+		if( _stopping )
+			return;
+
+		last_run = _run_id;
+		// workers beyond the number of threads asked for this run sit it out
+		if( worker >= _number_workers )
+			continue;
+
+		lock.unlock();
+		_job( rng );
+		lock.lock();
+
+		if( --_running_workers == 0 )
+			_run_done.notify_one();
+	}
+}
+
+void WorkerPool::run( int number_threads, Random &rng, std::function<void( Random & )> job )
+{
+	int number_workers = std::max( 0, number_threads - 1 );
+
+	{
+		std::lock_guard<std::mutex> lock( _run_lock );
+		for( int worker = static_cast<int>( _workers.size() ) ; worker < number_workers ; ++worker )
+			_workers.emplace_back( &WorkerPool::run_worker, this, worker, rng() );
+
+		_job = std::move( job );
+		_number_workers = number_workers;
+		_running_workers = number_workers;
+		++_run_id;
+	}
+	_run_ready.notify_all();
+
+	_job( rng );
+
+	std::unique_lock<std::mutex> lock( _run_lock );
+	_run_done.wait( lock, [&]() { return _running_workers == 0; } );
+}
@@ -0,0 +1,43 @@
+#ifndef POBO_WORKER_POOL_HPP
+#define POBO_WORKER_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "random.hpp"
+
+// Most threads a search or a batch of playouts runs on, when asked through JNI
+constexpr int MAX_NUMBER_THREADS = 16;
+
+// Threads kept alive from one parallel run to the next, so that their thread_local data
+// (e.g., evaluation_table) stays warm, and no threads are started for each run.
+// Workers are started by the first run needing them, and stopped with the pool.
+class WorkerPool
+{
+	std::vector<std::thread> _workers;
+	std::mutex _run_lock;
+	std::condition_variable _run_ready;
+	std::condition_variable _run_done;
+	std::uint64_t _run_id;
+	int _number_workers; // workers taking part in the current run
+	int _running_workers;
+	bool _stopping;
+	std::function<void( Random & )> _job;
+
+	void run_worker( int worker, std::uint64_t seed );
+
+public:
+	WorkerPool();
+	~WorkerPool();
+
+	// Call job on number_threads threads: the calling one with rng, and number_threads - 1 workers,
+	// each one with its own generator, seeded from rng when the worker starts. Return once all calls are done.
+	void run( int number_threads, Random &rng, std::function<void( Random & )> job );
+};
+
+#endif //POBO_WORKER_POOL_HPP
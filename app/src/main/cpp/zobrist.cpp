@@ -0,0 +1,17 @@
+#include "zobrist.hpp"
+
+std::uint64_t zobrist_hash( const jbyte * const grid,
+                            const Pool &blue_pool,
+                            const Pool &red_pool,
+                            jboolean blue_turn )
+{
+	std::uint64_t hash = zobrist_pools( blue_pool, red_pool );
+
+	for( int index = 0 ; index < 36 ; ++index )
+		hash ^= zobrist_cell( index, grid[ index ] );
+
+	if( blue_turn )
+		hash ^= zobrist_keys.blue_turn;
+
+	return hash;
+}
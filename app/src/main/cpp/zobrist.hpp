@@ -0,0 +1,72 @@
+#ifndef POBO_ZOBRIST_HPP
+#define POBO_ZOBRIST_HPP
+
+#include <cstdint>
+#include "jni_types.hpp"
+#include "pool.hpp"
+
+// Zobrist hashing: the hash of a position is the xor of one key per piece on the grid,
+// one key per pool content and one key if Blue is to move.
+// Placing, moving or removing a piece is then a couple of xors (see simulate_push and simulate_promotion).
+struct ZobristKeys
+{
+	std::uint64_t cell[36][5]; // indexed by the cell value + 2, from Blue Bo to Red Bo. Empty cells have a null key.
+	std::uint64_t blue_pool[9][9]; // indexed by number of Po, then number of Bo
+	std::uint64_t red_pool[9][9];
+	std::uint64_t blue_turn;
+};
+
+// Keys are drawn by splitmix64 at compile time, so hashes are the same from one run to another
+constexpr ZobristKeys make_zobrist_keys()
+{
+	ZobristKeys keys{};
+	std::uint64_t seed = 0x506f426f5a6f6272; // "PoBoZobr"
+
+	auto next_key = [&seed]()
+	{
+		std::uint64_t z = ( seed += 0x9e3779b97f4a7c15 );
+		z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9;
+		z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111eb;
+		return z ^ ( z >> 31 );
+	};
+
+	for( int index = 0 ; index < 36 ; ++index )
+		for( int value = 0 ; value < 5 ; ++value )
+			keys.cell[ index ][ value ] = value == 2 ? 0 : next_key();
+
+	for( int po = 0 ; po < 9 ; ++po )
+		for( int bo = 0 ; bo < 9 ; ++bo )
+		{
+			keys.blue_pool[ po ][ bo ] = next_key();
+			keys.red_pool[ po ][ bo ] = next_key();
+		}
+
+	keys.blue_turn = next_key();
+	return keys;
+}
+
+inline constexpr ZobristKeys zobrist_keys = make_zobrist_keys();
+
+inline std::uint64_t zobrist_cell( int index, jbyte value )
+{
+	return zobrist_keys.cell[ index ][ value + 2 ];
+}
+
+inline std::uint64_t zobrist_pools( const Pool &blue_pool, const Pool &red_pool )
+{
+	return zobrist_keys.blue_pool[ blue_pool.po ][ blue_pool.bo ] ^ zobrist_keys.red_pool[ red_pool.po ][ red_pool.bo ];
+}
+
+std::uint64_t zobrist_hash( const jbyte * const grid,
+                            const Pool &blue_pool,
+                            const Pool &red_pool,
+                            jboolean blue_turn );
+
+// heuristic_state does not depend on the player to move but on the player it scores the state for:
+// hash of the same position with perspective_is_blue as the player to move.
+inline std::uint64_t zobrist_perspective( std::uint64_t hash, jboolean blue_turn, jboolean perspective_is_blue )
+{
+	return !blue_turn == !perspective_is_blue ? hash : hash ^ zobrist_keys.blue_turn;
+}
+
+#endif //POBO_ZOBRIST_HPP
@@ -16,4 +16,7 @@ abstract class AI(val color: Color, val aiLevel:Int  = 0) {
     game: Game,
     timeout_in_ms: Long = 1000
   ): List<Position>
+
+  // Free the native resources held by the AI, which must not be used afterwards
+  open fun release() {}
 }
@@ -0,0 +1,108 @@
+package fr.richoux.pobo.engine.ai
+
+import android.util.Log
+import fr.richoux.pobo.engine.*
+
+private const val TAG = "pobotag AlphaBeta"
+
+// Native iterative-deepening alpha-beta search (see alpha_beta.hpp), within the given timeout
+class AlphaBeta(
+  color: Color,
+  aiLevel: Int = 0,
+  val max_depth: Int = 64
+) : AI(color, aiLevel) {
+  companion object {
+    init {
+      System.loadLibrary("pobo")
+    }
+
+    // Returns the score, the search depth, then the principal variation as (piece, row, column) triples
+    external fun alpha_beta_cpp(
+      session: Long,
+      grid: ByteArray,
+      blue_pool: ByteArray,
+      red_pool: ByteArray,
+      blue_pool_size: Int,
+      red_pool_size: Int,
+      blue_turn: Boolean,
+      move_number: Int,
+      timeout_in_ms: Long,
+      max_depth: Int
+    ): DoubleArray
+  }
+
+  // Native state kept for the game, holding the transposition table (see session.hpp)
+  private var session: Long = MCTS_GHOST.create_session()
+
+  // synchronized with select_move, so that the session is not deleted during a search
+  @Synchronized
+  override fun release() {
+    MCTS_GHOST.delete_session(session)
+    session = 0
+  }
+
+  @Synchronized
+  override fun select_move(game: Game, lastOpponentMove: Move?, timeout_in_ms: Long): Move {
+    val result = alpha_beta_cpp(
+      session,
+      game.board.grid,
+      game.board.bluePool.toByteArray(),
+      game.board.redPool.toByteArray(),
+      game.board.bluePool.size,
+      game.board.redPool.size,
+      game.currentPlayer == Color.Blue,
+      game.moveNumber,
+      timeout_in_ms,
+      max_depth
+    )
+
+    // not even a 1-ply search finished in time, or the session has been released
+    if(result.size < 5)
+      return randomPlay(game)
+
+    Log.d(TAG, "Depth ${result[1].toInt()}, score ${result[0]}, principal variation of ${(result.size - 2) / 3} moves")
+
+    val code = when(game.currentPlayer) {
+      Color.Blue -> -result[2].toInt()
+      Color.Red -> result[2].toInt()
+    }
+
+    val id = when(code) {
+      -2 -> "BB"
+      -1 -> "BP"
+      1 -> "RP"
+      else -> "RB"
+    }
+    val piece = Piece(id, code.toByte())
+    val position = Position(result[4].toInt(), result[3].toInt())
+    return Move(piece, position)
+  }
+
+  override fun select_promotion(game: Game, timeout_in_ms: Long): List<Position> {
+    val potentialPromotions = game.getPossiblePromotions()
+    val promotionScores = MCTS_GHOST.compute_promotions_cpp(
+      game.board.grid,
+      game.currentPlayer == Color.Blue,
+      game.board.bluePool.size,
+      game.board.redPool.size
+    )
+    var best_score = -10000.0
+    var best_groups: MutableList<Int> = mutableListOf()
+
+    promotionScores.forEachIndexed { index, score ->
+      if(best_score < score) {
+        best_score = score
+        best_groups.clear()
+        best_groups.add(index)
+      } else if(best_score == score) {
+        best_groups.add(index)
+      }
+    }
+
+    return potentialPromotions[best_groups.random()]
+  }
+
+  override fun toString(): String {
+    return "Alpha-Beta"
+  }
+}
@@ -4,6 +4,7 @@ import android.util.Log
 import fr.richoux.pobo.engine.*
 import java.lang.Math.sqrt
 import java.lang.StrictMath.abs
+import java.nio.ByteBuffer
 import kotlin.math.ln
 import kotlin.math.pow
 
@@ -59,7 +60,11 @@ class MCTS_GHOST(
   val first_n_strategy: Int = 21,
   val playout_depth: Int = 21,
   val action_masking_time: Int = 6,
-  val discount_score: Double = 0.9
+  val discount_score: Double = 0.9,
+  val native_search: Boolean = true,
+  val native_playouts: Boolean = true, // for the Kotlin search only
+  val playouts_per_leaf: Int = 1, // with native playouts only, averaged, at most NativeBuffers.NUMBER_MOVE_SLOTS
+  val number_threads: Int = Runtime.getRuntime().availableProcessors() // for the native search and playouts only
 ) : AI(color, aiLevel) {
   companion object {
     init {
@@ -89,6 +94,19 @@ class MCTS_GHOST(
       number_preselected_actions: Int
     ): IntArray
 
+    external fun score_moves_cpp(
+      grid: ByteArray,
+      blue_pool: ByteArray,
+      red_pool: ByteArray,
+      blue_pool_size: Int,
+      red_pool_size: Int,
+      blue_turn: Boolean
+    ): DoubleArray
+
+    // Index of a move in the array returned by score_moves_cpp: Po moves first, then Bo moves
+    fun move_slot(move: Move): Int =
+      (abs(move.piece.code.toInt()) - 1) * 36 + move.to.y * 6 + move.to.x
+
     external fun heuristic_state_cpp(
       grid: ByteArray,
       blue_turn: Boolean,
@@ -104,13 +122,147 @@ class MCTS_GHOST(
       blue_pool_size: Int,
       red_pool_size: Int
     ): DoubleArray
+
+    // Native state kept for a game (see session.hpp), as an opaque handle to give to delete_session
+    external fun create_session(): Long
+
+    external fun delete_session(session: Long)
+
+    // Make native random choices reproducible from one run to another (see seed_random in random.hpp),
+    // for benchmarks and regression runs. Sessions and searches created afterwards are seeded from it.
+    external fun seed_native_random(seed: Long)
+
+    // Same as the functions above, reading inputs from and writing outputs to NativeBuffers
+    external fun ghost_solver_call_direct(session: Long, input: ByteBuffer, output: ByteBuffer)
+
+    external fun score_moves_direct(input: ByteBuffer, output: ByteBuffer)
+
+    external fun heuristic_state_direct(input: ByteBuffer): Double
+
+    // Write in output the move slots (see move_slot) of the number_preselected_actions best moves,
+    // ties being broken randomly. Return the number of slots written.
+    external fun preselected_moves_direct(
+      session: Long,
+      input: ByteBuffer,
+      output: ByteBuffer,
+      number_preselected_actions: Int
+    ): Int
+
+    // Whole playout from the state in input, returning the same score as playout
+    external fun playout_direct(
+      session: Long,
+      input: ByteBuffer,
+      perspective_is_blue: Boolean,
+      first_n_strategy: Int,
+      playout_depth: Int,
+      discount_score: Double
+    ): Double
+
+    // number_playouts playouts from the state in input on number_threads threads,
+    // writing their scores in output. Return the number of scores written.
+    external fun playouts_direct(
+      session: Long,
+      input: ByteBuffer,
+      output: ByteBuffer,
+      number_playouts: Int,
+      perspective_is_blue: Boolean,
+      first_n_strategy: Int,
+      playout_depth: Int,
+      discount_score: Double,
+      number_threads: Int
+    ): Int
+
+    // Return the number of promotion scores written in output
+    external fun compute_promotions_direct(input: ByteBuffer, output: ByteBuffer): Int
+
+    external fun mcts_cpp(
+      session: Long,
+      grid: ByteArray,
+      blue_pool: ByteArray,
+      red_pool: ByteArray,
+      blue_pool_size: Int,
+      red_pool_size: Int,
+      blue_turn: Boolean,
+      move_number: Int,
+      ai_is_blue: Boolean,
+      ai_level: Int,
+      timeout_in_ms: Long,
+      number_preselected_actions: Int,
+      expansions_with_GHOST: Boolean,
+      first_n_strategy: Int,
+      playout_depth: Int,
+      action_masking_time: Int,
+      discount_score: Double,
+      number_threads: Int
+    ): IntArray
+  }
+
+  private val buffers = NativeBuffers()
+  // move slots kept by action masking
+  private val preselected_slots = BooleanArray(NativeBuffers.NUMBER_MOVE_SLOTS)
+  private var session: Long = create_session()
+
+  // synchronized with select_move, so that the session is not deleted during a search
+  @Synchronized
+  override fun release() {
+    delete_session(session)
+    session = 0
   }
 
+  // null if the native search could not run, i.e., the session has been released
+  private fun native_select_move(
+    game: Game,
+    timeout_in_ms: Long
+  ): Move? {
+    val solution = mcts_cpp(
+      session,
+      game.board.grid,
+      game.board.bluePool.toByteArray(),
+      game.board.redPool.toByteArray(),
+      game.board.bluePool.size,
+      game.board.redPool.size,
+      game.currentPlayer == Color.Blue,
+      game.moveNumber,
+      color == Color.Blue,
+      aiLevel,
+      timeout_in_ms,
+      number_preselected_actions,
+      expansions_with_GHOST,
+      first_n_strategy,
+      playout_depth,
+      action_masking_time,
+      discount_score,
+      number_threads
+    )
+
+    if(solution[0] == 42)
+      return null
+
+    val code = when(game.currentPlayer) {
+      Color.Blue -> -solution[0]
+      Color.Red -> solution[0]
+    }
+
+    val id = when(code) {
+      -2 -> "BB"
+      -1 -> "BP"
+      1 -> "RP"
+      else -> "RB"
+    }
+    val piece = Piece(id, code.toByte())
+    val position = Position(solution[2], solution[1])
+    return Move(piece, position)
+  }
+
+  @Synchronized
   override fun select_move(
     game: Game,
     lastOpponentMove: Move?,
     timeout_in_ms: Long
   ): Move {
+    if(native_search)
+      native_select_move(game, timeout_in_ms)?.let { return it }
+
     val start = System.currentTimeMillis()
     currentGame = game.copyForPlayout()
     lastMove = lastOpponentMove
@@ -186,43 +338,23 @@ class MCTS_GHOST(
 //            Log.d(TAG, "Is Blue turn: $blueTurn")
 //            Log.d(TAG, "\n")
 
-      val possible_moves = ghost_solver_call_full(
-        currentNode.game.board.grid,
-        currentNode.game.board.bluePool.toByteArray(),
-        currentNode.game.board.redPool.toByteArray(),
-        currentNode.game.board.bluePool.size,
-        currentNode.game.board.redPool.size,
-        currentNode.game.currentPlayer == Color.Blue,
+      // keep the number_preselected_actions best moves, ties being broken randomly
+      buffers.setState(currentNode.game.board, currentNode.game.currentPlayer == Color.Blue)
+      val numberPreselected = preselected_moves_direct(
+        session,
+        buffers.input,
+        buffers.output,
         number_preselected_actions
       )
 
-//      Log.d(TAG, "Possible moves:")
-//      for(i in 0..(possible_moves.size / 3) - 1) {
-//        Log.d(
-//          TAG,
-//          "Piece ${possible_moves[3 * i]} at (${'a' + possible_moves[3 * i + 2]},${6 - possible_moves[3 * i + 1]})"
-//        )
-//      }
+      preselected_slots.fill(false)
+      for(i in 0 until numberPreselected)
+        preselected_slots[buffers.slot(i)] = true
 
-      if(possible_moves[0] != 42) {
-        var actionToKeep: Boolean
+      if(numberPreselected > 0) {
         for(childID in currentNode.childID) {
-          actionToKeep = false
-          for(i in 0..(possible_moves.size / 3) - 1) {
-            val code = when(nodes[childID].player) {
-              Color.Blue -> -(nodes[childID].move?.piece?.code!!.toInt())
-              Color.Red -> nodes[childID].move?.piece?.code!!.toInt()
-            }
-            if(code == possible_moves[3 * i]
-              && nodes[childID].move?.to?.x == possible_moves[3 * i + 2]
-              && nodes[childID].move?.to?.y == possible_moves[3 * i + 1]
-            ) {
-              actionToKeep = true
-//                                Log.d(TAG,"Action masking: move ${nodes[childID].move} from node ${childID} has been pre-selected.")
-              break
-            }
-          }
-          if(!actionToKeep) {
+          val move = nodes[childID].move!!
+          if(!preselected_slots[move_slot(move)]) {
             actionMasking.add(childID)
 //                        Log.d(TAG,"Mask move ${nodes[childID].move} from node ${childID}")
           }
@@ -386,42 +518,21 @@ class MCTS_GHOST(
         move = randomPlay(selectedNode.game, movesToRemove.toList())
       }
       else {
-        var movesToRemoveRow: ByteArray = byteArrayOf()
-        var movesToRemoveColumn: ByteArray = byteArrayOf();
-        var movesToRemovePiece: ByteArray = byteArrayOf();
-
 //            Log.d(TAG,"Number of moves to remove: ${movesToRemove.size}")
-        for(move in movesToRemove) {
-//                Log.d(TAG,"Removed move=${move}")
-          movesToRemoveRow += move.to.y.toByte() // y are rows
-          movesToRemoveColumn += move.to.x.toByte() // x are columns
-          movesToRemovePiece += abs(move.piece.code.toInt()).toByte()
-        }
-
 //            Log.d(TAG, "GHOST call in Expansion")
-        val solution = ghost_solver_call(
-          selectedNode.game.board.grid,
-          selectedNode.game.board.bluePool.toByteArray(),
-          selectedNode.game.board.redPool.toByteArray(),
-          selectedNode.game.board.bluePool.size,
-          selectedNode.game.board.redPool.size,
-          selectedNode.game.currentPlayer == Color.Blue,
-          movesToRemoveRow,
-          movesToRemoveColumn,
-          movesToRemovePiece,
-          movesToRemove.size
-        )
+        buffers.setState(selectedNode.game.board, selectedNode.game.currentPlayer == Color.Blue, movesToRemove)
+        ghost_solver_call_direct(session, buffers.input, buffers.output)
 
         numberSolverCalls++
-        if(solution[0] == 42) {
+        if(buffers.solution(0) == 42) {
           move = randomPlay(selectedNode.game, movesToRemove.toList())
           numberSolverFailures++
 //                Log.d(TAG, "### Expansion: RANDOM move ${move}")
         }
         else {
           val code = when(selectedNode.game.currentPlayer) {
-            Color.Blue -> -solution[0]
-            Color.Red -> solution[0]
+            Color.Blue -> -buffers.solution(0)
+            Color.Red -> buffers.solution(0)
           }
 
           val id = when(code) {
@@ -431,9 +542,9 @@ class MCTS_GHOST(
             else -> "RB"
           }
           val piece = Piece(id, code.toByte())
-          val position = Position(solution[2], solution[1])
+          val position = Position(buffers.solution(2), buffers.solution(1))
           move = Move(piece, position)
-//                Log.d(TAG, "### Expansion: solver move ${move}, cost ${solution[3]}")
+//                Log.d(TAG, "### Expansion: solver move ${move}, cost ${buffers.solution(3)}")
         }
       }
 
@@ -690,6 +801,33 @@ class MCTS_GHOST(
   }
 
   fun playout(node: Node, first_n_strategy: Int = 0): Double {
+    if(native_playouts) {
+      // if node.player == Color.Red, then the selected node, i.e., node's parent, is blue
+      buffers.setState(node.game.board, node.game.currentPlayer == Color.Blue)
+      if(playouts_per_leaf <= 1)
+        return playout_direct(
+          session,
+          buffers.input,
+          node.player == Color.Red,
+          first_n_strategy,
+          playout_depth,
+          discount_score
+        )
+
+      val numberScores = playouts_direct(
+        session,
+        buffers.input,
+        buffers.output,
+        minOf(playouts_per_leaf, NativeBuffers.NUMBER_MOVE_SLOTS),
+        node.player == Color.Red,
+        first_n_strategy,
+        playout_depth,
+        discount_score,
+        number_threads
+      )
+      return if(numberScores == 0) 0.0 else (0 until numberScores).sumOf { buffers.score(it) } / numberScores
+    }
+
     var numberMoves = 0
 
     val game = node.game.copyForPlayout()
@@ -740,32 +878,19 @@ class MCTS_GHOST(
 //                Log.d(TAG,"### Playout: ${numberMoves} moves -> random move")
         move = randomPlay(game)
       } else {
-        val movesToRemoveRow: ByteArray = byteArrayOf()
-        val movesToRemoveColumn: ByteArray = byteArrayOf()
-        val movesToRemovePiece: ByteArray = byteArrayOf()
 //                Log.d(TAG, "GHOST call in Playouts")
-        val solution = ghost_solver_call(
-          game.board.grid,
-          game.board.bluePool.toByteArray(),
-          game.board.redPool.toByteArray(),
-          game.board.bluePool.size,
-          game.board.redPool.size,
-          game.currentPlayer == Color.Blue,
-          movesToRemoveRow,
-          movesToRemoveColumn,
-          movesToRemovePiece,
-          0
-        )
+        buffers.setState(game.board, game.currentPlayer == Color.Blue)
+        ghost_solver_call_direct(session, buffers.input, buffers.output)
 
 //                Log.d(TAG,"### Playout: ${numberMoves} moves -> solver called")
 
-        if(solution[0] == 42) {
+        if(buffers.solution(0) == 42) {
 //                    Log.d(TAG,"### Playout: no solution found -> random move")
           move = randomPlay(game)
         } else {
           val code = when(game.currentPlayer) {
-            Color.Blue -> -solution[0]
-            Color.Red -> solution[0]
+            Color.Blue -> -buffers.solution(0)
+            Color.Red -> buffers.solution(0)
           }
 
           val id = when(code) {
@@ -775,10 +900,10 @@ class MCTS_GHOST(
             else -> "RB"
           }
           val piece = Piece(id, code.toByte())
-          val position = Position(solution[2], solution[1])
+          val position = Position(buffers.solution(2), buffers.solution(1))
           move = Move(piece, position)
 
-//                    Log.d(TAG, "### Playout: solver move ${move}, cost ${solution[3]}")
+//                    Log.d(TAG, "### Playout: solver move ${move}, cost ${buffers.solution(3)}")
         }
       }
 
@@ -790,16 +915,13 @@ class MCTS_GHOST(
       // check if we need to promote a piece
       val potentialPromotions = game.getPossiblePromotions()
       if(!isBlueVictory && !isRedVictory && potentialPromotions.isNotEmpty()) {
-        val promotionScores = compute_promotions_cpp(
-          game.board.grid,
-          game.currentPlayer == Color.Blue,
-          game.board.bluePool.size,
-          game.board.redPool.size
-        )
+        buffers.setState(game.board, game.currentPlayer == Color.Blue)
+        val numberScores = compute_promotions_direct(buffers.input, buffers.output)
         var best_score = -10000.0
         var best_groups: MutableList<Int> = mutableListOf()
 
-        promotionScores.forEachIndexed { index, score ->
+        for(index in 0 until numberScores) {
+          val score = buffers.score(index)
           if(best_score < score) {
             best_score = score
             best_groups.clear()
@@ -816,14 +938,8 @@ class MCTS_GHOST(
       numberMoves++
 
       if(!isBlueVictory && !isRedVictory) {
-        val heuristic_score = heuristic_state_cpp(
-          game.board.grid,
-          selectedNodeColorIsBlue,
-          game.board.bluePool.toByteArray(),
-          game.board.bluePool.size,
-          game.board.redPool.toByteArray(),
-          game.board.redPool.size
-        )
+        buffers.setState(game.board, selectedNodeColorIsBlue)
+        val heuristic_score = heuristic_state_direct(buffers.input)
         val exponential_discount =
           discount_score.pow(numberMoves - 1) // -1 because we don't want any discount for the first move
         score += (exponential_discount * heuristic_score)
@@ -0,0 +1,54 @@
+package fr.richoux.pobo.engine.ai
+
+import fr.richoux.pobo.engine.*
+import java.lang.StrictMath.abs
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+// Direct buffers for the *_direct native functions, allocated once and reused for every call,
+// so that calls copy nothing and allocate nothing on the JVM heap.
+// Input layout (see pobo.cpp): grid, numbers of Po and Bo in the blue pool then in the red pool,
+// blue turn, number of moves to remove, then the (piece, row, column) of each move to remove.
+class NativeBuffers {
+  companion object {
+    const val NUMBER_MOVE_SLOTS = 72
+    private const val POOLS = 36
+    private const val BLUE_TURN = 40
+    private const val NUMBER_TO_REMOVE = 41
+    private const val TO_REMOVE = 42
+    const val INPUT_SIZE = TO_REMOVE + 3 * NUMBER_MOVE_SLOTS
+    const val OUTPUT_SIZE = NUMBER_MOVE_SLOTS * 8
+  }
+
+  val input: ByteBuffer = ByteBuffer.allocateDirect(INPUT_SIZE).order(ByteOrder.nativeOrder())
+  val output: ByteBuffer = ByteBuffer.allocateDirect(OUTPUT_SIZE).order(ByteOrder.nativeOrder())
+
+  fun setState(board: Board, blueTurn: Boolean, movesToRemove: List<Move> = emptyList()) {
+    for(i in 0..35)
+      input.put(i, board.grid[i])
+
+    input.put(POOLS, board.bluePool.count { it == PieceType.Po.value }.toByte())
+    input.put(POOLS + 1, board.bluePool.count { it == PieceType.Bo.value }.toByte())
+    input.put(POOLS + 2, board.redPool.count { it == PieceType.Po.value }.toByte())
+    input.put(POOLS + 3, board.redPool.count { it == PieceType.Bo.value }.toByte())
+    input.put(BLUE_TURN, if(blueTurn) 1 else 0)
+
+    val numberToRemove = minOf(movesToRemove.size, NUMBER_MOVE_SLOTS)
+    input.put(NUMBER_TO_REMOVE, numberToRemove.toByte())
+    for(i in 0 until numberToRemove) {
+      val move = movesToRemove[i]
+      input.put(TO_REMOVE + 3 * i, abs(move.piece.code.toInt()).toByte())
+      input.put(TO_REMOVE + 3 * i + 1, move.to.y.toByte()) // y are rows
+      input.put(TO_REMOVE + 3 * i + 2, move.to.x.toByte()) // x are columns
+    }
+  }
+
+  // i-th value written by ghost_solver_call_direct
+  fun solution(i: Int): Int = output.getInt(4 * i)
+
+  // i-th move slot written by preselected_moves_direct
+  fun slot(i: Int): Int = output.getInt(4 * i)
+
+  // i-th value written by score_moves_direct, compute_promotions_direct or playouts_direct
+  fun score(i: Int): Double = output.getDouble(8 * i)
+}
@@ -167,6 +167,12 @@ class GameViewModel : ViewModel() {
     }
   }
 
+  override fun onCleared() {
+    aiP1.release()
+    aiP2.release()
+    super.onCleared()
+  }
+
   fun newGame(
     navController: NavController,
     p1IsAI: Boolean,
@@ -194,6 +200,9 @@ class GameViewModel : ViewModel() {
       this.p2IsAI = p2IsAI
     }
 
+    aiP1.release()
+    aiP2.release()
+
     if(this.p1IsAI) {
 //      aiP1 = MCTS_GHOST(Color.Blue, number_preselected_actions = 0, expansions_with_GHOST = false, first_n_strategy = 0, playout_depth = 0) // Vanilla-MCTS
 //      aiP1 = MCTS_GHOST(Color.Blue, expansions_with_GHOST = false, first_n_strategy = 0, playout_depth = 0) // MCTS + Selection
@@ -204,6 +213,7 @@ class GameViewModel : ViewModel() {
 //      aiP1 = MCTS_GHOST(Color.Blue, number_preselected_actions = 0) // MCTS + Expansion + Playout
       aiP1 = MCTS_GHOST(Color.Blue, aiLevel) // full-GHOSTed MCTS
 //      aiP1 = PureHeuristics(Color.Blue)
+//      aiP1 = AlphaBeta(Color.Blue)
       if(!xp || countNumberGames == 1)
         Log.d(TAG, "Blue: ${aiP1.toString()}")
     }
@@ -217,6 +227,7 @@ class GameViewModel : ViewModel() {
 //      aiP2 = MCTS_GHOST(Color.Red, number_preselected_actions = 0) // MCTS + Expansion + Playout
       aiP2 = MCTS_GHOST(Color.Red, aiLevel) // full-GHOSTed MCTS
 //      aiP2 = PureHeuristics(Color.Red)
+//      aiP2 = AlphaBeta(Color.Red)
       if(!xp || countNumberGames == 1)
         Log.d(TAG, "Red: ${aiP2.toString()}")
     }